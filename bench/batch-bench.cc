@@ -0,0 +1,41 @@
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+#include "bench/inputs.hh"
+#include "l1/conv-qual/batch.hh"
+
+namespace {
+
+constexpr std::size_t kLines = std::size_t{1} << 16;
+
+std::string makeBatch() {
+  std::string text{};
+  for (const auto &[from, to] : bench::makeTypePairs(kLines, 8)) {
+    text += from;
+    text += '\t';
+    text += to;
+    text += '\n';
+  }
+  return text;
+}
+
+// BatchChecker with range(0) threads, 0 for one per CPU.
+void BM_BatchCheckText(benchmark::State &state) {
+  auto text = makeBatch();
+  auto threads = static_cast<unsigned>(state.range(0));
+  l1::BatchChecker checker{threads != 0 ? threads
+                                        : std::thread::hardware_concurrency()};
+  for (auto _ : state)
+    benchmark::DoNotOptimize(checker.checkText(text, nullptr));
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(kLines));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<std::int64_t>(text.size()));
+}
+BENCHMARK(BM_BatchCheckText)->Arg(1)->Arg(0)->UseRealTime();
+
+} // namespace
@@ -0,0 +1,120 @@
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "bench/inputs.hh"
+#include "l1/conv-qual/conv-qual.hh"
+#include "l1/conv-qual/tokenizing.hh"
+
+namespace {
+
+constexpr std::size_t kPairs = 1024;
+
+void BM_Tokenize(benchmark::State &state) {
+  auto pairs =
+      bench::makeTypePairs(kPairs, static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state)
+    for (const auto &[from, to] : pairs)
+      benchmark::DoNotOptimize(l1::tokenize(from));
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(pairs.size()));
+}
+BENCHMARK(BM_Tokenize)->Arg(2)->Arg(8)->Arg(64);
+
+// Every other input is malformed, the errors come back as values.
+void BM_TryTokenizeMalformed(benchmark::State &state) {
+  auto inputs = bench::makeTokenizeInputs(
+      kPairs, static_cast<std::size_t>(state.range(0)), 50);
+
+  std::size_t failures = 0;
+  for (const auto &input : inputs)
+    if (!l1::tryTokenize(input))
+      ++failures;
+  if (failures != kPairs / 2) {
+    state.SkipWithError("inputs are not half malformed");
+    return;
+  }
+
+  for (auto _ : state)
+    for (const auto &input : inputs)
+      benchmark::DoNotOptimize(l1::tryTokenize(input));
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(inputs.size()));
+}
+BENCHMARK(BM_TryTokenizeMalformed)->Arg(2)->Arg(8)->Arg(64);
+
+/* The cost of an error in the three ways to report it, on short types with
+   range(0) percent of them malformed. */
+template <typename Fn> void tokenizeShare(benchmark::State &state, Fn fn) {
+  auto invalidPercent = static_cast<std::size_t>(state.range(0));
+  auto inputs = bench::makeTokenizeInputs(kPairs, 4, invalidPercent);
+  for (auto _ : state)
+    for (const auto &input : inputs)
+      benchmark::DoNotOptimize(fn(input));
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(inputs.size()));
+}
+
+void BM_TokenizeThrowing(benchmark::State &state) {
+  tokenizeShare(state, [](const std::string &input) {
+    try {
+      return !l1::tokenize(input).empty();
+    } catch (const std::runtime_error &) {
+      return false;
+    }
+  });
+}
+BENCHMARK(BM_TokenizeThrowing)->Arg(0)->Arg(50)->Arg(90)->Arg(100);
+
+void BM_TryTokenize(benchmark::State &state) {
+  tokenizeShare(state, [](const std::string &input) {
+    return l1::tryTokenize(input).has_value();
+  });
+}
+BENCHMARK(BM_TryTokenize)->Arg(0)->Arg(50)->Arg(90)->Arg(100);
+
+void BM_TryTokenizeErrorMessage(benchmark::State &state) {
+  tokenizeShare(state, [](const std::string &input) {
+    auto tokens = l1::tryTokenize(input);
+    if (!tokens)
+      return l1::errorMessage(tokens.error(), input).empty();
+    return true;
+  });
+}
+BENCHMARK(BM_TryTokenizeErrorMessage)->Arg(0)->Arg(50)->Arg(90)->Arg(100);
+
+void BM_Testqual(benchmark::State &state) {
+  auto pairs =
+      bench::makeTypePairs(kPairs, static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state)
+    for (const auto &[from, to] : pairs)
+      benchmark::DoNotOptimize(l1::testqual(std::string_view{from}, to));
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(pairs.size()));
+}
+BENCHMARK(BM_Testqual)->Arg(2)->Arg(8)->Arg(64);
+
+// Only the combine and compare step, on decompositions computed upfront.
+void BM_TestqualDecomposed(benchmark::State &state) {
+  auto pairs =
+      bench::makeTypePairs(kPairs, static_cast<std::size_t>(state.range(0)));
+  std::vector<std::pair<l1::PackedQDecomp, l1::PackedQDecomp>> decomps{};
+  for (const auto &[from, to] : pairs)
+    decomps.emplace_back(l1::PackedQDecomp::Get(l1::tokenize(from)),
+                         l1::PackedQDecomp::Get(l1::tokenize(to)));
+
+  for (auto _ : state)
+    for (const auto &[from, to] : decomps)
+      benchmark::DoNotOptimize(l1::testqual(from, to));
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(decomps.size()));
+}
+BENCHMARK(BM_TestqualDecomposed)->Arg(2)->Arg(8)->Arg(64);
+
+} // namespace
@@ -0,0 +1,81 @@
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <benchmark/benchmark.h>
+
+#include "bench/inputs.hh"
+#include "l1/cow/cow.hh"
+
+namespace {
+
+void BM_StringCopy(benchmark::State &state) {
+  auto str = bench::makeText(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    std::string copy = str;
+    benchmark::DoNotOptimize(copy.data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StringCopy)->Range(16, 1 << 16);
+
+void BM_COWCopy(benchmark::State &state) {
+  l1::COWString str{bench::makeText(static_cast<std::size_t>(state.range(0)))};
+  for (auto _ : state) {
+    l1::COWString copy = str;
+    benchmark::DoNotOptimize(copy.data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_COWCopy)->Range(16, 1 << 16);
+
+// Copy, then write to the copy: every write detaches.
+void BM_COWDetach(benchmark::State &state) {
+  l1::COWString str{bench::makeText(static_cast<std::size_t>(state.range(0)))};
+  for (auto _ : state) {
+    l1::COWString copy = str;
+    copy.setChar(0, 'x');
+    benchmark::DoNotOptimize(copy.data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_COWDetach)->Range(16, 1 << 16);
+
+// Writes to an unshared string, detach only checks the use count.
+void BM_COWSetCharUnique(benchmark::State &state) {
+  l1::COWString str{bench::makeText(static_cast<std::size_t>(state.range(0)))};
+  std::size_t i = 0;
+  for (auto _ : state) {
+    str.setChar(i, 'x');
+    i = (i + 1) % str.size();
+  }
+  benchmark::DoNotOptimize(str.data());
+}
+BENCHMARK(BM_COWSetCharUnique)->Arg(1 << 10);
+
+// The needle only occurs at the very end of the text.
+void BM_COWFind(benchmark::State &state) {
+  auto text = bench::makeText(static_cast<std::size_t>(state.range(0)));
+  text += " qqqqqq";
+  l1::COWString str{text};
+  for (auto _ : state)
+    benchmark::DoNotOptimize(str.find(std::string_view{"qqqqqq"}));
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_COWFind)->Range(1 << 10, 1 << 20);
+
+void BM_COWTokenizer(benchmark::State &state) {
+  l1::COWString str{bench::makeText(static_cast<std::size_t>(state.range(0)))};
+  std::size_t tokens = 0;
+  for (auto _ : state) {
+    l1::COWTokenizer<char> tokenizer{str, ' '};
+    for (auto token = tokenizer.get(); !token.empty(); token = tokenizer.get())
+      ++tokens;
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(tokens));
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_COWTokenizer)->Range(1 << 10, 1 << 20);
+
+} // namespace
@@ -0,0 +1,87 @@
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "bench/inputs.hh"
+#include "l1/conv-qual/conv-qual.hh"
+#include "l1/conv-qual/decomp-cache.hh"
+
+namespace {
+
+using Pairs = std::vector<std::pair<std::string, std::string>>;
+
+constexpr std::size_t kPairs = std::size_t{1} << 16;
+
+// range(0) picks the input: 0 for 2000 repeated spellings, 1 for distinct.
+const Pairs &pairsOf(const benchmark::State &state) {
+  static const auto repeated = bench::makeRepeatedTypePairs(2000, kPairs);
+  static const auto distinct = bench::makeDistinctTypePairs(kPairs);
+  return state.range(0) == 0 ? repeated : distinct;
+}
+
+// One thread, then one per CPU if there are several.
+void threadCounts(benchmark::internal::Benchmark *bm) {
+  bm->Threads(1);
+  if (std::thread::hardware_concurrency() > 1)
+    bm->ThreadPerCpu();
+  bm->UseRealTime();
+}
+
+// Every thread checks its own stride of the pairs.
+template <typename Check>
+void checkPairs(benchmark::State &state, const Pairs &pairs, Check check) {
+  auto threads = static_cast<std::size_t>(state.threads());
+  std::size_t checked = 0;
+  for (auto _ : state)
+    for (auto i = static_cast<std::size_t>(state.thread_index());
+         i < pairs.size(); i += threads, ++checked)
+      benchmark::DoNotOptimize(check(pairs[i].first, pairs[i].second));
+  state.SetItemsProcessed(static_cast<std::int64_t>(checked));
+}
+
+void BM_TestqualUncached(benchmark::State &state) {
+  checkPairs(state, pairsOf(state),
+             [](const std::string &from, const std::string &to) {
+               return l1::testqual(from, to);
+             });
+}
+BENCHMARK(BM_TestqualUncached)
+    ->ArgName("distinct")
+    ->Arg(0)
+    ->Arg(1)
+    ->Apply(threadCounts);
+
+/* One cache shared by all threads of a run, made by thread 0 before the
+   timing starts. Reports the hit ratio of the cache range(1) selects:
+   decompositions only when 0, verdicts too otherwise. */
+void BM_DecompCache(benchmark::State &state) {
+  static std::optional<l1::DecompCache> cache{};
+  bool verdicts = state.range(1) != 0;
+  if (state.thread_index() == 0)
+    cache.emplace(4096, verdicts ? std::size_t{1} << 16 : 0);
+
+  checkPairs(state, pairsOf(state),
+             [](const std::string &from, const std::string &to) {
+               return cache->testqual(from, to);
+             });
+
+  if (state.thread_index() == 0) {
+    auto counters =
+        verdicts ? cache->verdictCounters() : cache->decompCounters();
+    state.counters["hit_ratio"] =
+        static_cast<double>(counters.hits) /
+        static_cast<double>(counters.hits + counters.misses);
+  }
+}
+BENCHMARK(BM_DecompCache)
+    ->ArgNames({"distinct", "verdicts"})
+    ->ArgsProduct({{0, 1}, {0, 1}})
+    ->Apply(threadCounts);
+
+} // namespace
@@ -0,0 +1,152 @@
+#ifndef __BENCH_INPUTS_HH__
+#define __BENCH_INPUTS_HH__
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+/* Lowercase words with roughly the length distribution of English prose,
+   mostly separated by one space and sometimes by a run of them. */
+inline std::vector<std::string> makeWords(std::size_t count,
+                                          std::uint32_t seed = 42) {
+  std::mt19937 gen{seed};
+  std::discrete_distribution<std::size_t> length{
+      {3, 17, 20, 16, 11, 9, 8, 6, 4, 3, 2, 1}};
+  std::uniform_int_distribution<int> letter{'a', 'z'};
+
+  std::vector<std::string> words{};
+  words.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    std::string word(length(gen) + 1, ' ');
+    for (auto &c : word)
+      c = static_cast<char>(letter(gen));
+    words.push_back(std::move(word));
+  }
+  return words;
+}
+
+inline std::string makeText(std::size_t bytes, std::uint32_t seed = 42) {
+  std::mt19937 gen{seed};
+  std::geometric_distribution<std::size_t> extraSpaces{0.8};
+
+  std::string text{};
+  text.reserve(bytes + 16);
+  while (text.size() < bytes)
+    for (const auto &word : makeWords(256, static_cast<std::uint32_t>(gen()))) {
+      text += word;
+      text.append(1 + extraSpaces(gen), ' ');
+    }
+  text.resize(bytes);
+  return text;
+}
+
+/* Pointer/array chain over char: depth levels, const levels taken from the
+   bits of constMask, the outermost level an array when arr is set.
+   Distinct (depth, constMask, arr) give distinct spellings, even after
+   DecompCache::normalize. */
+inline std::string makeType(std::size_t depth, std::uint64_t constMask,
+                            bool arr) {
+  std::string type = (constMask & 1) ? "char const" : "char";
+  for (std::size_t i = 1; i <= depth; ++i) {
+    type += (arr && i == depth) ? " []" : " *";
+    if (i != depth && ((constMask >> i) & 1))
+      type += "const";
+  }
+  return type;
+}
+
+/* (from, to) pairs like the ones a qualification conversion check sees:
+   to is from with a few more const levels, or an unrelated type in about
+   a quarter of the pairs. */
+inline std::vector<std::pair<std::string, std::string>>
+makeTypePairs(std::size_t count, std::size_t maxDepth,
+              std::uint32_t seed = 42) {
+  std::mt19937_64 gen{seed};
+  std::uniform_int_distribution<std::size_t> depth{1, maxDepth};
+  std::bernoulli_distribution unrelated{0.25};
+  std::bernoulli_distribution arr{0.1};
+
+  std::vector<std::pair<std::string, std::string>> pairs{};
+  pairs.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    auto d = depth(gen);
+    auto from = gen() & gen();
+    auto to = unrelated(gen) ? gen() : from | (gen() & gen() & gen());
+    auto isArr = arr(gen);
+    pairs.emplace_back(makeType(d, from, isArr), makeType(d, to, isArr));
+  }
+  return pairs;
+}
+
+/* count pairs drawn from only spellings distinct types, so that a cache of
+   that many entries hits on almost every lookup. */
+inline std::vector<std::pair<std::string, std::string>>
+makeRepeatedTypePairs(std::size_t spellings, std::size_t count,
+                      std::uint32_t seed = 42) {
+  std::mt19937 gen{seed};
+  std::vector<std::string> pool{};
+  pool.reserve(spellings);
+  for (std::size_t i = 0; i < spellings; ++i)
+    pool.push_back(makeType(1 + i % 10, gen(), i % 5 == 0));
+
+  std::uniform_int_distribution<std::size_t> pick{0, pool.size() - 1};
+  std::vector<std::pair<std::string, std::string>> pairs{};
+  pairs.reserve(count);
+  for (std::size_t i = 0; i < count; ++i)
+    pairs.emplace_back(pool[pick(gen)], pool[pick(gen)]);
+  return pairs;
+}
+
+/* count pairs in which no spelling repeats (for up to 2^19 pairs), so that
+   caches never hit. */
+inline std::vector<std::pair<std::string, std::string>>
+makeDistinctTypePairs(std::size_t count) {
+  std::vector<std::pair<std::string, std::string>> pairs{};
+  pairs.reserve(count);
+  for (std::uint64_t i = 0; i < count; ++i)
+    pairs.emplace_back(makeType(20, i, false), makeType(20, ~i, false));
+  return pairs;
+}
+
+/* Breaks a type made by makeType in one of the ways the tokenizer tells
+   apart: an unknown word for the lexer, a second const or a misplaced
+   char for the DFA. */
+inline std::string makeMalformed(std::string type, std::uint64_t how) {
+  switch (how % 3) {
+  case 0:
+    return type + " x";
+  case 1:
+    return type + " const const";
+  default:
+    return type + " char";
+  }
+}
+
+/* The from sides of makeTypePairs, of which count * invalidPercent / 100
+   (rounded down) in random places are broken by makeMalformed. */
+inline std::vector<std::string> makeTokenizeInputs(std::size_t count,
+                                                   std::size_t maxDepth,
+                                                   std::size_t invalidPercent,
+                                                   std::uint32_t seed = 42) {
+  std::mt19937_64 gen{seed};
+  auto invalid = count * invalidPercent / 100;
+
+  std::vector<std::string> inputs{};
+  inputs.reserve(count);
+  for (auto &[from, to] : makeTypePairs(count, maxDepth, seed))
+    inputs.push_back(inputs.size() < invalid ? makeMalformed(from, gen())
+                                             : std::move(from));
+  std::shuffle(inputs.begin(), inputs.end(), gen);
+  return inputs;
+}
+
+} // namespace bench
+
+#endif // __BENCH_INPUTS_HH__
@@ -0,0 +1,72 @@
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <benchmark/benchmark.h>
+
+#include "bench/inputs.hh"
+#include "l1/conv-qual/push-tokenizer.hh"
+#include "l1/conv-qual/tokenizing.hh"
+
+namespace {
+
+constexpr std::size_t kLines = 4096;
+
+// One declaration per line, a tenth of them malformed.
+std::string makeDeclarations() {
+  std::string text{};
+  for (const auto &type : bench::makeTokenizeInputs(kLines, 8, 10)) {
+    text += type;
+    text += '\n';
+  }
+  return text;
+}
+
+struct CountingSink final {
+  std::size_t tokens = 0;
+  std::size_t declarations = 0;
+  std::size_t errors = 0;
+
+  void token(l1::Token) { ++tokens; }
+  void declaration(std::size_t) { ++declarations; }
+  void error(std::size_t, const l1::TokenizeError &) { ++errors; }
+};
+
+// The text arrives in chunks of range(0) bytes.
+void BM_PushTokenizer(benchmark::State &state) {
+  auto text = makeDeclarations();
+  auto chunk = static_cast<std::size_t>(state.range(0));
+  for (auto _ : state) {
+    l1::PushTokenizer<CountingSink> tokenizer{};
+    for (std::size_t pos = 0; pos < text.size(); pos += chunk)
+      tokenizer.feed(std::string_view{text}.substr(pos, chunk));
+    tokenizer.finish();
+    benchmark::DoNotOptimize(tokenizer.sink());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(kLines));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<std::int64_t>(text.size()));
+}
+BENCHMARK(BM_PushTokenizer)->Arg(16)->Arg(4096)->Arg(1 << 20);
+
+// What the push tokenizer replaces: cutting whole lines and tokenizing them.
+void BM_TryTokenizeLines(benchmark::State &state) {
+  auto text = makeDeclarations();
+  for (auto _ : state) {
+    std::string_view rest = text;
+    while (!rest.empty()) {
+      auto eol = rest.find('\n');
+      benchmark::DoNotOptimize(l1::tryTokenize(rest.substr(0, eol)));
+      rest.remove_prefix(eol == rest.npos ? rest.size() : eol + 1);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<std::int64_t>(kLines));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<std::int64_t>(text.size()));
+}
+BENCHMARK(BM_TryTokenizeLines);
+
+} // namespace
@@ -0,0 +1,109 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "l6/tuple-sort/soa-vector.hh"
+
+namespace {
+
+// A wide record of which the scans below only read one or two fields.
+using Order = std::tuple<std::uint64_t,        // id
+                         double,               // price
+                         double,               // quantity
+                         std::uint32_t,        // flags
+                         std::array<char, 40>, // symbol
+                         std::int64_t,         // timestamp
+                         double>;              // fee
+
+std::vector<Order> makeOrders(std::size_t n) {
+  std::mt19937_64 gen{42};
+  std::uniform_real_distribution<double> price{1, 1000};
+  std::uniform_real_distribution<double> quantity{1, 100};
+
+  std::vector<Order> orders{};
+  orders.reserve(n);
+  for (std::size_t i = 0; i < n; ++i)
+    orders.emplace_back(i, price(gen), quantity(gen),
+                        static_cast<std::uint32_t>(gen()),
+                        std::array<char, 40>{}, static_cast<std::int64_t>(i),
+                        0.0);
+  return orders;
+}
+
+struct SumPrice final {
+  double operator()(const std::vector<Order> &orders) const {
+    double sum = 0;
+    for (const auto &order : orders)
+      sum += std::get<1>(order);
+    return sum;
+  }
+  double operator()(const l6::SoaVector<Order> &orders) const {
+    double sum = 0;
+    for (auto price : orders.column<1>())
+      sum += price;
+    return sum;
+  }
+};
+
+struct SumNotional final {
+  double operator()(const std::vector<Order> &orders) const {
+    double sum = 0;
+    for (const auto &order : orders)
+      sum += std::get<1>(order) * std::get<2>(order);
+    return sum;
+  }
+  double operator()(const l6::SoaVector<Order> &orders) const {
+    auto prices = orders.column<1>();
+    auto quantities = orders.column<2>();
+    double sum = 0;
+    for (std::size_t i = 0; i < prices.size(); ++i)
+      sum += prices[i] * quantities[i];
+    return sum;
+  }
+};
+
+struct CountFlags final {
+  std::size_t operator()(const std::vector<Order> &orders) const {
+    std::size_t count = 0;
+    for (const auto &order : orders)
+      count += std::get<3>(order) & 1;
+    return count;
+  }
+  std::size_t operator()(const l6::SoaVector<Order> &orders) const {
+    std::size_t count = 0;
+    for (auto flags : orders.column<3>())
+      count += flags & 1;
+    return count;
+  }
+};
+
+// Scan over range(0) rows stored as a vector of tuples.
+template <typename Scan> void BM_AosScan(benchmark::State &state) {
+  auto orders = makeOrders(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(Scan{}(orders));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// The same scan with every column in its own array.
+template <typename Scan> void BM_SoaScan(benchmark::State &state) {
+  l6::SoaVector<Order> orders{
+      makeOrders(static_cast<std::size_t>(state.range(0)))};
+  for (auto _ : state)
+    benchmark::DoNotOptimize(Scan{}(orders));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(BM_AosScan, SumPrice)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(BM_SoaScan, SumPrice)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(BM_AosScan, SumNotional)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(BM_SoaScan, SumNotional)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(BM_AosScan, CountFlags)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(BM_SoaScan, CountFlags)->Range(1 << 10, 1 << 22);
+
+} // namespace
@@ -0,0 +1,62 @@
+#include <cstddef>
+#include <string>
+#include <utility>
+
+#include <benchmark/benchmark.h>
+
+#include "bench/inputs.hh"
+#include "l1/streq/streq.hh"
+
+namespace {
+
+enum class Case { eEqual, eLastDiffers, eSizeDiffers };
+
+// Two strings in separate buffers, related as the case says.
+std::pair<std::string, std::string> makeOperands(std::size_t size,
+                                                 Case kind) {
+  auto lhs = bench::makeText(size);
+  auto rhs = lhs;
+  if (kind == Case::eLastDiffers)
+    rhs.back() = lhs.back() == 'x' ? 'y' : 'x';
+  if (kind == Case::eSizeDiffers)
+    rhs.push_back('x');
+  return {lhs, rhs};
+}
+
+template <Case kind> void BM_L1Equal(benchmark::State &state) {
+  auto [lhs, rhs] =
+      makeOperands(static_cast<std::size_t>(state.range(0)), kind);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lhs.data());
+    benchmark::DoNotOptimize(l1::operator==(lhs, rhs));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_L1Equal<Case::eEqual>)->Range(8, 1 << 16);
+BENCHMARK(BM_L1Equal<Case::eLastDiffers>)->Range(8, 1 << 16);
+BENCHMARK(BM_L1Equal<Case::eSizeDiffers>)->Range(8, 1 << 16);
+
+template <Case kind> void BM_StdEqual(benchmark::State &state) {
+  auto [lhs, rhs] =
+      makeOperands(static_cast<std::size_t>(state.range(0)), kind);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lhs.data());
+    benchmark::DoNotOptimize(std::operator==(lhs, rhs));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StdEqual<Case::eEqual>)->Range(8, 1 << 16);
+BENCHMARK(BM_StdEqual<Case::eLastDiffers>)->Range(8, 1 << 16);
+
+void BM_L1EqualCString(benchmark::State &state) {
+  auto [lhs, rhs] =
+      makeOperands(static_cast<std::size_t>(state.range(0)), Case::eEqual);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lhs.data());
+    benchmark::DoNotOptimize(l1::operator==(lhs, rhs.c_str()));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_L1EqualCString)->Range(8, 1 << 16);
+
+} // namespace
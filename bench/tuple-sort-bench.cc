@@ -0,0 +1,59 @@
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include <benchmark/benchmark.h>
+
+#include "l6/tuple-sort/tuple-sort.hh"
+
+namespace {
+
+// A record with heavy members: the strings are too long for SSO.
+using Record = std::tuple<std::string, char, double, std::int32_t,
+                          std::string, std::int16_t>;
+
+Record makeRecord() {
+  return {std::string(64, 'a'), 'b', 1.0, 2, std::string(48, 'c'), 3};
+}
+
+// Baseline: one copy of the record.
+void BM_TupleCopy(benchmark::State &state) {
+  auto record = makeRecord();
+  for (auto _ : state) {
+    auto copy = record;
+    benchmark::DoNotOptimize(copy);
+  }
+}
+BENCHMARK(BM_TupleCopy);
+
+void BM_SortLvalue(benchmark::State &state) {
+  auto record = makeRecord();
+  for (auto _ : state) {
+    auto sorted = l6::sort(record);
+    benchmark::DoNotOptimize(sorted);
+  }
+}
+BENCHMARK(BM_SortLvalue);
+
+// Copy, then sort the copy by moves: should cost about BM_TupleCopy.
+void BM_SortRvalue(benchmark::State &state) {
+  auto record = makeRecord();
+  for (auto _ : state) {
+    auto copy = record;
+    auto sorted = l6::sort(std::move(copy));
+    benchmark::DoNotOptimize(sorted);
+  }
+}
+BENCHMARK(BM_SortRvalue);
+
+void BM_HanaSort(benchmark::State &state) {
+  auto record = makeRecord();
+  for (auto _ : state) {
+    auto sorted = l6::hanaSort(record);
+    benchmark::DoNotOptimize(sorted);
+  }
+}
+BENCHMARK(BM_HanaSort);
+
+} // namespace
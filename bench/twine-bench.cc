@@ -0,0 +1,66 @@
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "bench/inputs.hh"
+#include "l1/twine/twine.hh"
+
+namespace {
+
+l1::StringTwine build(const std::vector<std::string> &pieces) {
+  l1::StringTwine twine{};
+  for (const auto &piece : pieces)
+    twine.concatOne(piece);
+  return twine;
+}
+
+std::size_t totalSize(const std::vector<std::string> &pieces) {
+  std::size_t size = 0;
+  for (const auto &piece : pieces)
+    size += piece.size();
+  return size;
+}
+
+void BM_TwineBuild(benchmark::State &state) {
+  auto pieces = bench::makeWords(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    auto twine = build(pieces);
+    benchmark::DoNotOptimize(twine);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TwineBuild)->Range(8, 4096);
+
+void BM_TwineFlatten(benchmark::State &state) {
+  auto pieces = bench::makeWords(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    auto str = build(pieces).str();
+    benchmark::DoNotOptimize(str.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<std::int64_t>(totalSize(pieces)));
+}
+BENCHMARK(BM_TwineFlatten)->Range(8, 4096);
+
+// What the twine competes with: appending to one string.
+void BM_StringAppend(benchmark::State &state) {
+  auto pieces = bench::makeWords(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    std::string str{};
+    for (const auto &piece : pieces)
+      str += piece;
+    benchmark::DoNotOptimize(str.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<std::int64_t>(totalSize(pieces)));
+}
+BENCHMARK(BM_StringAppend)->Range(8, 4096);
+
+} // namespace
@@ -95,6 +95,13 @@ function(apply_compiler_flags TARGET VISIBILIY)
     "$<$<CXX_COMPILER_ID:GNU>:$<$<CONFIG:Debug>:${GCC_WARNINGS}>>")
 endfunction()
 
+set(BENCH_FLAGS -O3 -DNDEBUG -fno-omit-frame-pointer)
+
+# Benchmarks are optimized whatever CMAKE_BUILD_TYPE is.
+function(apply_bench_flags TARGET VISIBILIY)
+  target_compile_options(${TARGET} ${VISIBILIY} ${BENCH_FLAGS})
+endfunction()
+
 string(REPLACE " " ";" DED_SAN_LST "${SANITIZERS}")
 string(REPLACE " " ";" DED_GCC_WARNS_LST "${COMMON_WARNINGS}")
 string(REPLACE " " ";" DED_GCC_WARNS_LST "${GCC_WARNINGS}")
@@ -0,0 +1,56 @@
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <fmt/base.h>
+
+#include "batch.hh"
+
+/* Usage: l1-conv-qual-batch [-j THREADS] [FILE]
+
+   Reads "from<TAB>to" lines from FILE (mmap'd) or from stdin when FILE is
+   missing or "-", prints one verdict per input line to stdout and the
+   throughput to stderr. */
+int main(int argc, char **argv) try {
+  using namespace l1;
+  using namespace std::literals;
+
+  auto threads = std::thread::hardware_concurrency();
+  std::string path = "-";
+  for (int i = 1; i < argc; ++i) {
+    if (argv[i] == "-j"sv && i + 1 < argc)
+      threads = static_cast<unsigned>(std::stoul(argv[++i]));
+    else
+      path = argv[i];
+  }
+
+  BatchChecker checker{threads};
+
+  auto start = std::chrono::steady_clock::now();
+  BatchStats stats{};
+  if (path == "-") {
+    stats = checker.checkStream(stdin, stdout);
+  } else {
+    MappedFile file{path};
+    stats = checker.checkText(file.view(), stdout);
+  }
+  std::fflush(stdout);
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  auto seconds = elapsed.count();
+  fmt::println(stderr,
+               "{} lines ({} convertible, {} not convertible, {} malformed) "
+               "in {:.3f} s on {} threads: {:.0f} lines/s, {:.1f} MiB/s",
+               stats.lines, stats.convertible, stats.notConvertible,
+               stats.malformed, seconds, checker.threads(),
+               static_cast<double>(stats.lines) / seconds,
+               static_cast<double>(stats.bytes) / seconds / (1 << 20));
+  return 0;
+} catch (const std::exception &e) {
+  fmt::println(stderr, "error: {}", e.what());
+  return 1;
+}
@@ -0,0 +1,114 @@
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "batch.hh"
+
+using namespace l1;
+using namespace std::literals;
+
+namespace {
+
+const std::vector<std::pair<std::string_view, Verdict>> kSamples{
+    {"char **\tchar const *const *", Verdict::eConvertible},
+    {"char **\tchar const **", Verdict::eNotConvertible},
+    {"char[]\tchar *", Verdict::eConvertible},
+    {"char *const *\tchar **", Verdict::eNotConvertible},
+    {"constchar\tchar", Verdict::eMalformed},
+    {"char * no tab", Verdict::eMalformed},
+    {"", Verdict::eMalformed},
+    {"char *[]\tchar *const *\r", Verdict::eConvertible},
+};
+
+std::string makeInput(std::size_t repeat) {
+  std::string input{};
+  for (std::size_t i = 0; i < repeat; ++i)
+    for (const auto &[line, verdict] : kSamples) {
+      input += line;
+      input += '\n';
+    }
+  return input;
+}
+
+std::string readAll(std::FILE *file) {
+  std::rewind(file);
+  std::string res{};
+  for (int c = std::fgetc(file); c != EOF; c = std::fgetc(file))
+    res += static_cast<char>(c);
+  return res;
+}
+
+std::string expectedOutput(std::size_t repeat) {
+  std::string res{};
+  for (std::size_t i = 0; i < repeat; ++i)
+    for (const auto &[line, verdict] : kSamples)
+      res += fmt::format("{}\n", verdict);
+  return res;
+}
+
+} // namespace
+
+TEST(Batch, CheckLine) {
+  for (const auto &[line, verdict] : kSamples)
+    EXPECT_EQ(checkLine(line), verdict) << line;
+}
+
+TEST(Batch, CheckKeepsOrder) {
+  std::vector<std::string_view> lines{};
+  for (std::size_t i = 0; i < 1000; ++i)
+    for (const auto &[line, verdict] : kSamples)
+      lines.push_back(line);
+
+  std::vector<Verdict> verdicts(lines.size());
+  BatchChecker checker{4};
+  checker.check(lines, verdicts);
+
+  for (std::size_t i = 0; i < lines.size(); ++i)
+    ASSERT_EQ(verdicts[i], kSamples[i % kSamples.size()].second) << i;
+}
+
+TEST(Batch, CheckText) {
+  constexpr std::size_t repeat = 100;
+  auto input = makeInput(repeat);
+  input.pop_back(); // no trailing newline
+
+  auto *out = std::tmpfile();
+  ASSERT_NE(out, nullptr);
+  BatchChecker checker{3};
+  auto stats = checker.checkText(input, out, 7);
+
+  EXPECT_EQ(stats.lines, repeat * kSamples.size());
+  EXPECT_EQ(stats.bytes, input.size());
+  EXPECT_EQ(stats.malformed, repeat * 3);
+  EXPECT_EQ(readAll(out), expectedOutput(repeat));
+  std::fclose(out);
+}
+
+TEST(Batch, CheckStream) {
+  constexpr std::size_t repeat = 100;
+  auto input = makeInput(repeat);
+
+  auto *in = std::tmpfile();
+  auto *out = std::tmpfile();
+  ASSERT_NE(in, nullptr);
+  ASSERT_NE(out, nullptr);
+  std::fwrite(input.data(), 1, input.size(), in);
+  std::rewind(in);
+
+  // Chunks shorter than a line force the reader to grow its buffer.
+  BatchChecker checker{2};
+  auto stats = checker.checkStream(in, out, 5);
+
+  EXPECT_EQ(stats.lines, repeat * kSamples.size());
+  EXPECT_EQ(stats.bytes, input.size());
+  EXPECT_EQ(readAll(out), expectedOutput(repeat));
+
+  std::rewind(in);
+  EXPECT_THROW(checker.checkStream(in, out, 0), std::invalid_argument);
+  std::fclose(in);
+  std::fclose(out);
+}
@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+#include "batch.hh"
+#include "conv-qual.hh"
+
+namespace l1 {
+
+Verdict checkLine(std::string_view line) {
+  if (!line.empty() && line.back() == '\r')
+    line.remove_suffix(1);
+
+  auto tab = line.find('\t');
+  if (tab == line.npos)
+    return Verdict::eMalformed;
+
+  auto res = tryTestqual(line.substr(0, tab), line.substr(tab + 1));
+  if (!res)
+    return Verdict::eMalformed;
+  return *res ? Verdict::eConvertible : Verdict::eNotConvertible;
+}
+
+void BatchStats::add(Verdict verdict) {
+  ++lines;
+  switch (verdict) {
+  case Verdict::eConvertible:
+    ++convertible;
+    break;
+  case Verdict::eNotConvertible:
+    ++notConvertible;
+    break;
+  case Verdict::eMalformed:
+    ++malformed;
+    break;
+  default:
+    break;
+  }
+}
+
+BatchStats &BatchStats::operator+=(const BatchStats &other) {
+  lines += other.lines;
+  bytes += other.bytes;
+  convertible += other.convertible;
+  notConvertible += other.notConvertible;
+  malformed += other.malformed;
+  return *this;
+}
+
+BatchChecker::BatchChecker(unsigned threads) {
+  // The calling thread takes part in every check() as well.
+  auto extra = std::max(threads, 1u) - 1;
+  workers_.reserve(extra);
+  for (unsigned i = 0; i < extra; ++i)
+    workers_.emplace_back([this] { loop(); });
+}
+
+BatchChecker::~BatchChecker() {
+  {
+    std::lock_guard lock{mutex_};
+    stop_ = true;
+  }
+  wake_.notify_all();
+  workers_.clear();
+}
+
+// Must not throw: workers would terminate, and check() would return while
+// they still use the job on its stack.
+void BatchChecker::run(Job &job) noexcept {
+  auto size = job.lines.size();
+  try {
+    for (;;) {
+      auto begin = job.next.fetch_add(kChunk, std::memory_order_relaxed);
+      if (begin >= size)
+        return;
+
+      auto end = std::min(begin + kChunk, size);
+      for (auto i = begin; i < end; ++i)
+        job.verdicts[i] = checkLine(job.lines[i]);
+    }
+  } catch (...) {
+    if (!job.failed.test_and_set())
+      job.error = std::current_exception();
+    job.next.store(size, std::memory_order_relaxed);
+  }
+}
+
+void BatchChecker::loop() {
+  std::size_t seen = 0;
+  for (;;) {
+    Job *job = nullptr;
+    {
+      std::unique_lock lock{mutex_};
+      wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+      if (stop_)
+        return;
+      seen = generation_;
+      job = job_;
+    }
+
+    run(*job);
+
+    std::lock_guard lock{mutex_};
+    if (--busy_ == 0)
+      done_.notify_one();
+  }
+}
+
+void BatchChecker::check(std::span<const std::string_view> lines,
+                         std::span<Verdict> verdicts) {
+  if (lines.size() != verdicts.size())
+    throw std::invalid_argument{"lines and verdicts sizes differ"};
+
+  Job job{.lines = lines, .verdicts = verdicts};
+  {
+    std::lock_guard lock{mutex_};
+    job_ = &job;
+    busy_ = workers_.size();
+    ++generation_;
+  }
+  wake_.notify_all();
+
+  run(job);
+
+  std::unique_lock lock{mutex_};
+  done_.wait(lock, [&] { return busy_ == 0; });
+  job_ = nullptr;
+
+  if (job.error)
+    std::rethrow_exception(job.error);
+}
+
+BatchStats BatchChecker::checkText(std::string_view text, std::FILE *out,
+                                   std::size_t batchLines) {
+  BatchStats stats{};
+  stats.bytes = text.size();
+
+  std::vector<std::string_view> lines{};
+  std::vector<Verdict> verdicts{};
+  fmt::memory_buffer buf{};
+  lines.reserve(batchLines);
+
+  auto flush = [&] {
+    verdicts.resize(lines.size());
+    check(lines, verdicts);
+
+    buf.clear();
+    for (auto verdict : verdicts) {
+      stats.add(verdict);
+      fmt::format_to(std::back_inserter(buf), "{}\n", verdict);
+    }
+    if (out != nullptr)
+      std::fwrite(buf.data(), 1, buf.size(), out);
+    lines.clear();
+  };
+
+  while (!text.empty()) {
+    auto eol = text.find('\n');
+    lines.push_back(text.substr(0, eol));
+    text.remove_prefix(eol == text.npos ? text.size() : eol + 1);
+
+    if (lines.size() == batchLines)
+      flush();
+  }
+
+  if (!lines.empty())
+    flush();
+
+  return stats;
+}
+
+BatchStats BatchChecker::checkStream(std::FILE *in, std::FILE *out,
+                                     std::size_t chunkBytes) {
+  if (chunkBytes == 0)
+    throw std::invalid_argument{"chunkBytes is zero"};
+
+  BatchStats stats{};
+  std::string buf(chunkBytes, '\0');
+  std::size_t tail = 0;
+
+  for (;;) {
+    if (tail == buf.size())
+      buf.resize(buf.size() * 2);
+
+    auto read = std::fread(buf.data() + tail, 1, buf.size() - tail, in);
+    auto filled = tail + read;
+    if (read == 0) {
+      if (std::ferror(in))
+        throw std::system_error{errno, std::generic_category(), "fread"};
+      stats += checkText({buf.data(), filled}, out);
+      return stats;
+    }
+
+    // Only complete lines are checked, the rest waits for the next chunk.
+    std::string_view data{buf.data(), filled};
+    auto eol = data.rfind('\n');
+    if (eol == data.npos) {
+      tail = filled;
+      continue;
+    }
+
+    stats += checkText(data.substr(0, eol + 1), out);
+    tail = filled - (eol + 1);
+    std::memmove(buf.data(), buf.data() + eol + 1, tail);
+  }
+}
+
+MappedFile::MappedFile(const std::string &path) {
+  auto fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw std::system_error{errno, std::generic_category(), path};
+
+  struct stat st {};
+  if (::fstat(fd, &st) < 0) {
+    auto err = errno;
+    ::close(fd);
+    throw std::system_error{err, std::generic_category(), path};
+  }
+
+  size_ = static_cast<std::size_t>(st.st_size);
+  if (size_ != 0) {
+    auto *addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+      auto err = errno;
+      ::close(fd);
+      throw std::system_error{err, std::generic_category(), path};
+    }
+    ::madvise(addr, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const char *>(addr);
+  }
+
+  ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr)
+    ::munmap(const_cast<char *>(data_), size_);
+}
+
+} // namespace l1
@@ -0,0 +1,136 @@
+#ifndef __L1_CONV_QUAL_BATCH_HH__
+#define __L1_CONV_QUAL_BATCH_HH__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fmt/base.h>
+
+namespace l1 {
+
+enum class Verdict : std::uint8_t { eConvertible, eNotConvertible, eMalformed };
+
+/* Checks one "from<TAB>to" line. Lines without a tab or with types which
+   do not tokenize are eMalformed. */
+Verdict checkLine(std::string_view line);
+
+struct BatchStats final {
+  std::size_t lines = 0;
+  std::size_t bytes = 0;
+  std::size_t convertible = 0;
+  std::size_t notConvertible = 0;
+  std::size_t malformed = 0;
+
+  void add(Verdict verdict);
+  BatchStats &operator+=(const BatchStats &other);
+};
+
+/* Fixed pool of worker threads. check() splits lines into chunks which are
+   grabbed by the workers (and the calling thread) through an atomic
+   counter; verdicts[i] always belongs to lines[i]. There is one job slot,
+   so check() and the checkText/checkStream built on it must not be called
+   from two threads at once on the same checker. */
+class BatchChecker final {
+private:
+  struct Job final {
+    std::span<const std::string_view> lines;
+    std::span<Verdict> verdicts;
+    std::atomic<std::size_t> next{0};
+    std::atomic_flag failed{};
+    std::exception_ptr error{}; // the first exception of any thread
+  };
+
+  static constexpr std::size_t kChunk = 256;
+
+  std::mutex mutex_{};
+  std::condition_variable wake_{};
+  std::condition_variable done_{};
+  std::size_t generation_ = 0;
+  std::size_t busy_ = 0;
+  bool stop_ = false;
+  Job *job_ = nullptr;
+  std::vector<std::jthread> workers_{};
+
+  static void run(Job &job) noexcept;
+  void loop();
+
+public:
+  explicit BatchChecker(unsigned threads = std::thread::hardware_concurrency());
+  BatchChecker(const BatchChecker &) = delete;
+  BatchChecker &operator=(const BatchChecker &) = delete;
+  ~BatchChecker();
+
+  unsigned threads() const {
+    return static_cast<unsigned>(workers_.size()) + 1;
+  }
+
+  /* Returns once every thread is done with lines and verdicts. If checking
+     a line throws (bad_alloc), the remaining chunks are skipped and the
+     first exception is rethrown here. */
+  void check(std::span<const std::string_view> lines,
+             std::span<Verdict> verdicts);
+
+  /* Checks every line of text and writes one verdict per line to out, in
+     input order. A missing trailing newline is fine. Lines are processed in
+     batches of batchLines, so memory does not grow with the input. */
+  BatchStats checkText(std::string_view text, std::FILE *out,
+                       std::size_t batchLines = std::size_t{1} << 16);
+
+  /* Same as checkText, but reads in from a stream chunk by chunk. Throws
+     std::invalid_argument for a chunkBytes of zero. */
+  BatchStats checkStream(std::FILE *in, std::FILE *out,
+                         std::size_t chunkBytes = std::size_t{1} << 24);
+};
+
+/* Read-only mmap of a whole file. */
+class MappedFile final {
+private:
+  const char *data_ = nullptr;
+  std::size_t size_ = 0;
+
+public:
+  explicit MappedFile(const std::string &path);
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  ~MappedFile();
+
+  std::string_view view() const { return {data_, size_}; }
+};
+
+} // namespace l1
+
+template <>
+struct fmt::formatter<l1::Verdict> : fmt::formatter<fmt::string_view> {
+public:
+  template <typename FormatContext>
+  auto format(l1::Verdict verdict, FormatContext &ctx) const {
+    fmt::string_view name{};
+    switch (verdict) {
+    case l1::Verdict::eConvertible:
+      name = "convertible";
+      break;
+    case l1::Verdict::eNotConvertible:
+      name = "not-convertible";
+      break;
+    case l1::Verdict::eMalformed:
+      name = "malformed";
+      break;
+    default:
+      name = "UNKNOWN";
+      break;
+    }
+    return fmt::formatter<fmt::string_view>::format(name, ctx);
+  }
+};
+
+#endif // __L1_CONV_QUAL_BATCH_HH__
@@ -1,4 +1,7 @@
+#include <string>
+#include <string_view>
 #include <type_traits>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -50,3 +53,139 @@ TEST(ConvQual, Test) {
   CQ_CHECK(char **, char const *[]);
   CQ_CHECK(char *const *, char *[]);
 }
+
+#undef CQ_CHECK
+
+using namespace l1::literals;
+
+// Compile time counterparts of the checks above.
+#define CQ_STATIC_CHECK_NE(t1, t2)                                             \
+  static_assert(l1::testqual(#t1 ""_type, #t2 ""_type) !=                     \
+                    std::is_convertible_v<t1, t2>,                             \
+                #t1 " -> " #t2)
+
+CQ_STATIC_CHECK_NE(char *[], char *const[]);
+CQ_STATIC_CHECK_NE(char **, char *const[]);
+CQ_STATIC_CHECK_NE(char **const, char *[]);
+
+#undef CQ_STATIC_CHECK_NE
+
+#define CQ_STATIC_CHECK(t1, t2)                                                \
+  static_assert(l1::testqual(#t1 ""_type, #t2 ""_type) ==                     \
+                    std::is_convertible_v<t1, t2>,                             \
+                #t1 " -> " #t2)
+
+CQ_STATIC_CHECK(char[], char *);
+
+CQ_STATIC_CHECK(char const **, char **);
+CQ_STATIC_CHECK(char **, char const **);
+CQ_STATIC_CHECK(char *const *, char **);
+CQ_STATIC_CHECK(char **, char *const *);
+CQ_STATIC_CHECK(char **const, char **);
+CQ_STATIC_CHECK(char **, char **const);
+
+CQ_STATIC_CHECK(char const *[], char *[]);
+CQ_STATIC_CHECK(char *[], char const *[]);
+CQ_STATIC_CHECK(char *const[], char *[]);
+
+CQ_STATIC_CHECK(char const *[], char **);
+CQ_STATIC_CHECK(char *[], char const **);
+CQ_STATIC_CHECK(char *const[], char **);
+CQ_STATIC_CHECK(char *[], char *const *);
+CQ_STATIC_CHECK(char *[], char **const);
+
+CQ_STATIC_CHECK(char const **, char *[]);
+CQ_STATIC_CHECK(char **, char const *[]);
+CQ_STATIC_CHECK(char *const *, char *[]);
+
+#undef CQ_STATIC_CHECK
+
+static_assert(l1::tokenize("char const *const").size() == 4);
+static_assert(l1::PackedQDecomp::Get(l1::tokenize("char *const *[]")).depth ==
+              3);
+static_assert(l1::testqual("char **", "char const *const *"));
+
+// Shrinking clears the bits past the new depth, down to depth 0.
+static_assert([] {
+  auto packed = l1::PackedQDecomp::Get(l1::tokenize("char const *const *"));
+  packed.resize(1);
+  if (packed != l1::PackedQDecomp::Get(l1::tokenize("char const *")))
+    return false;
+  packed.resize(0);
+  return packed == l1::PackedQDecomp{} &&
+         packed.cvEquals(l1::PackedQDecomp::Get(l1::tokenize("char")));
+}());
+
+// The reference implementation is constexpr as well.
+static_assert(l1::QDecomp::GetQCombined(
+                  l1::QDecomp::Get(l1::tokenize("char **")),
+                  l1::QDecomp::Get(l1::tokenize("char const **"))) ==
+              l1::PackedQDecomp::GetQCombined(
+                  l1::PackedQDecomp::Get(l1::tokenize("char **")),
+                  l1::PackedQDecomp::Get(l1::tokenize("char const **")))
+                  .unpack());
+
+// Character buffers are checked at run time, whatever their size.
+TEST(ConvQual, Buffers) {
+  char from[16] = "char **";
+  char to[32] = "char const *const *";
+  EXPECT_TRUE(l1::testqual(from, to));
+  EXPECT_FALSE(l1::testqual(to, from));
+}
+
+TEST(ConvQual, PackedMatchesQDecomp) {
+  std::vector<std::string> types{
+      "char",          "char const",     "char *",         "char const *",
+      "char *const",   "char[]",         "char const[]",   "char **",
+      "char const **", "char *const *",  "char **const",   "char *[]",
+      "char const *[]", "char *const[]", "char const *const *const",
+      "char *const *[]", "char const **[]",
+  };
+
+  for (const auto &from : types)
+    for (const auto &to : types) {
+      auto tok1 = l1::tokenize(from);
+      auto tok2 = l1::tokenize(to);
+
+      auto q1 = l1::QDecomp::Get(tok1);
+      auto q2 = l1::QDecomp::Get(tok2);
+      auto p1 = l1::PackedQDecomp::Get(tok1);
+      auto p2 = l1::PackedQDecomp::Get(tok2);
+      ASSERT_EQ(q1, p1.unpack()) << from;
+      ASSERT_EQ(q2, p2.unpack()) << to;
+
+      auto q3 = l1::QDecomp::GetQCombined(q1, q2);
+      auto p3 = l1::PackedQDecomp::GetQCombined(p1, p2);
+      EXPECT_EQ(q3, p3.unpack()) << from << " -> " << to;
+      EXPECT_EQ(q2.cv == q3.cv, l1::testqual(from, to)) << from << " -> " << to;
+    }
+}
+
+TEST(ConvQual, PackedDeep) {
+  constexpr std::size_t depth = 2 * l1::PackedQDecomp::kWordBits + 3;
+
+  std::string ptrs = "char";
+  std::string constPtrs = "char const";
+  for (std::size_t i = 0; i < depth; ++i) {
+    ptrs += " *";
+    constPtrs += i + 1 == depth ? " *" : " *const";
+  }
+  std::string innerConst = "char const" + ptrs.substr(4);
+
+  EXPECT_TRUE(l1::testqual(ptrs, constPtrs));
+  EXPECT_FALSE(l1::testqual(ptrs, innerConst));
+  EXPECT_FALSE(l1::testqual(constPtrs, ptrs));
+
+  for (const auto &[from, to] : {std::pair{ptrs, constPtrs},
+                                 std::pair{ptrs, innerConst},
+                                 std::pair{innerConst, constPtrs}}) {
+    auto q1 = l1::QDecomp::Get(l1::tokenize(from));
+    auto q2 = l1::QDecomp::Get(l1::tokenize(to));
+    auto p1 = l1::PackedQDecomp::Get(l1::tokenize(from));
+    auto p2 = l1::PackedQDecomp::Get(l1::tokenize(to));
+    ASSERT_EQ(p1.depth, depth);
+    ASSERT_EQ(p1.cvExt.size(), 2u);
+    EXPECT_EQ(l1::QDecomp::GetQCombined(q1, q2),
+              l1::PackedQDecomp::GetQCombined(p1, p2).unpack());
+  }
+}
@@ -1,6 +1,16 @@
 #ifndef __L1_CONV_QUAL_CONV_QUAL_HH__
 #define __L1_CONV_QUAL_CONV_QUAL_HH__
 
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <limits>
+#include <span>
+#include <string_view>
+#include <vector>
+
 #include <fmt/base.h>
 #include <fmt/ranges.h>
 
@@ -55,45 +65,287 @@ public:
 
 namespace l1 {
 
+// Not constexpr, see throwTokenizeError.
+[[noreturn]] void throwUnexpectedToken(Token token);
+
 struct QDecomp final {
   std::vector<CV> cv;
   std::vector<P> p;
 
-  template <rng::range Range> static QDecomp Get(Range range) {
-    auto base = range | vws::drop(1) | vws::reverse | vws::drop(1);
-    auto rp = base | vws::stride(2) | vws::transform([](auto token) {
-                if (token == Token::eArr)
-                  return P::eArr;
-                else if (token == Token::ePtr)
-                  return P::ePtr;
-                else
-                  throw std::runtime_error{
-                      fmt::format("Unexpected token: {}", token)};
-              });
-    auto rcv =
-        base | vws::drop(1) | vws::stride(2) | vws::transform([](auto token) {
-          if (token == Token::eConst)
-            return CV::eConst;
-          else if (token == Token::eNonConst)
-            return CV::eNonConst;
-          else
-            throw std::runtime_error{
-                fmt::format("Unexpected token: {}", token)};
-        });
+  /* range is the output of tokenize(). Level 0 is the outermost
+     declarator, see PackedQDecomp::Get. */
+  template <rng::range Range> static constexpr QDecomp Get(Range range) {
+    std::vector<Token> tokens{};
+    for (auto token : range)
+      tokens.push_back(token);
+
+    QDecomp res{};
+    if (tokens.size() < 2)
+      return res;
+
+    auto depth = (tokens.size() - 2) / 2;
+    for (std::size_t level = 0; level < depth; ++level) {
+      auto pToken = tokens[2 * (depth - level)];
+      auto cvToken = tokens[2 * (depth - level) - 1];
+
+      if (pToken == Token::eArr)
+        res.p.push_back(P::eArr);
+      else if (pToken == Token::ePtr)
+        res.p.push_back(P::ePtr);
+      else
+        throwUnexpectedToken(pToken);
+
+      if (cvToken == Token::eConst)
+        res.cv.push_back(CV::eConst);
+      else if (cvToken == Token::eNonConst)
+        res.cv.push_back(CV::eNonConst);
+      else
+        throwUnexpectedToken(cvToken);
+    }
+
+    return res;
+  }
+
+  static constexpr QDecomp GetQCombined(const QDecomp &t1, const QDecomp &t2);
+
+  constexpr bool operator==(const QDecomp &) const = default;
+};
+
+/* Level by level: the array wins over the pointer, const wins over
+   non-const. Every level above the deepest one where the result differs
+   from either operand becomes const. */
+constexpr QDecomp QDecomp::GetQCombined(const QDecomp &t1, const QDecomp &t2) {
+  auto depth = std::min(t1.p.size(), t2.p.size());
+
+  QDecomp res{};
+  std::size_t constAbove = 0;
+  for (std::size_t level = 0; level < depth; ++level) {
+    auto p3 = t2.p[level] == P::eArr ? P::eArr : t1.p[level];
+    auto cv3 = t1.cv[level] == CV::eConst || t2.cv[level] == CV::eConst
+                   ? CV::eConst
+                   : CV::eNonConst;
+    if (cv3 != t1.cv[level] || cv3 != t2.cv[level] || p3 != t1.p[level] ||
+        p3 != t2.p[level])
+      constAbove = level;
+
+    res.p.push_back(p3);
+    res.cv.push_back(cv3);
+  }
+
+  std::fill_n(res.cv.begin(), constAbove, CV::eConst);
+  return res;
+}
+
+/* Same decomposition as QDecomp, but every level is a single bit:
+   bit i of the cv mask is set for a const level, bit i of the p mask is set
+   for an array level. The first kWordBits levels live in cv/p, deeper types
+   spill into cvExt/pExt, one word per kWordBits levels. Bits past depth are
+   always zero. Everything here is constexpr, so together with tokenize()
+   the whole check can run at compile time. */
+struct PackedQDecomp final {
+  using Word = std::uint64_t;
+  static constexpr std::size_t kWordBits = std::numeric_limits<Word>::digits;
+
+  std::size_t depth = 0;
+  Word cv = 0;
+  Word p = 0;
+  std::vector<Word> cvExt;
+  std::vector<Word> pExt;
+
+  constexpr std::size_t words() const {
+    return (depth + kWordBits - 1) / kWordBits;
+  }
+
+  constexpr Word cvWord(std::size_t w) const {
+    return w == 0 ? cv : cvExt[w - 1];
+  }
+  constexpr Word pWord(std::size_t w) const {
+    return w == 0 ? p : pExt[w - 1];
+  }
+
+  // Bits of word w which correspond to existing levels.
+  constexpr Word levelMask(std::size_t w) const {
+    auto rest = depth - w * kWordBits;
+    return rest >= kWordBits ? ~Word{0} : (Word{1} << rest) - 1;
+  }
+
+  // Word 0 is masked even at depth 0, which clears it.
+  constexpr void resize(std::size_t newDepth) {
+    depth = newDepth;
+    auto used = std::max(words(), std::size_t{1});
+    cvExt.resize(used - 1);
+    pExt.resize(used - 1);
+    for (std::size_t w = 0; w < used; ++w)
+      setWords(w, cvWord(w), pWord(w));
+  }
+
+  constexpr void setWords(std::size_t w, Word cvBits, Word pBits) {
+    auto mask = levelMask(w);
+    (w == 0 ? cv : cvExt[w - 1]) = cvBits & mask;
+    (w == 0 ? p : pExt[w - 1]) = pBits & mask;
+  }
+
+  constexpr void setLevel(std::size_t level, P pLevel, CV cvLevel) {
+    auto w = level / kWordBits;
+    auto bit = Word{1} << (level % kWordBits);
+    auto cvBits = cvWord(w) & ~bit;
+    auto pBits = pWord(w) & ~bit;
+    if (cvLevel == CV::eConst)
+      cvBits |= bit;
+    if (pLevel == P::eArr)
+      pBits |= bit;
+    setWords(w, cvBits, pBits);
+  }
+
+  constexpr bool cvEquals(const PackedQDecomp &other) const {
+    return depth == other.depth && cv == other.cv && cvExt == other.cvExt;
+  }
 
+  constexpr QDecomp unpack() const {
     QDecomp res{};
-    for (auto [p, cv] : vws::zip(rp, rcv)) {
-      res.p.push_back(p);
-      res.cv.push_back(cv);
+    for (std::size_t level = 0; level < depth; ++level) {
+      auto w = level / kWordBits;
+      auto bit = Word{1} << (level % kWordBits);
+      res.cv.push_back((cvWord(w) & bit) ? CV::eConst : CV::eNonConst);
+      res.p.push_back((pWord(w) & bit) ? P::eArr : P::ePtr);
     }
+    return res;
+  }
 
+  static constexpr PackedQDecomp Get(std::span<const Token> tokens);
+  static constexpr PackedQDecomp GetQCombined(const PackedQDecomp &t1,
+                                              const PackedQDecomp &t2);
+
+  constexpr bool operator==(const PackedQDecomp &) const = default;
+};
+
+/* tokenize() yields [char, cv, P1, cv1, ..., Pn, cvn], innermost declarator
+   first. Level 0 is the outermost one: Pn together with the cv of what it
+   points to, i.e. cv(n-1). The top-level cv (cvn) does not take part. */
+constexpr PackedQDecomp PackedQDecomp::Get(std::span<const Token> tokens) {
+  PackedQDecomp res{};
+  if (tokens.size() < 2)
     return res;
+
+  auto depth = (tokens.size() - 2) / 2;
+  res.resize(depth);
+  for (std::size_t level = 0; level < depth; ++level) {
+    auto pToken = tokens[2 * (depth - level)];
+    auto cvToken = tokens[2 * (depth - level) - 1];
+
+    P pLevel{};
+    if (pToken == Token::eArr)
+      pLevel = P::eArr;
+    else if (pToken == Token::ePtr)
+      pLevel = P::ePtr;
+    else
+      throwUnexpectedToken(pToken);
+
+    CV cvLevel{};
+    if (cvToken == Token::eConst)
+      cvLevel = CV::eConst;
+    else if (cvToken == Token::eNonConst)
+      cvLevel = CV::eNonConst;
+    else
+      throwUnexpectedToken(cvToken);
+
+    res.setLevel(level, pLevel, cvLevel);
   }
 
-  static QDecomp GetQCombined(const QDecomp &t1, const QDecomp &t2);
+  return res;
+}
+
+/* Word-parallel version of QDecomp::GetQCombined. Within a word:
+     p3  = p1 | p2 (array wins),
+     cv3 = cv1 | cv2,
+   and the highest level where cv3/p3 differs from either operand is the
+   top bit of diff; every level above it (lower bits, lower words) becomes
+   const. */
+constexpr PackedQDecomp PackedQDecomp::GetQCombined(const PackedQDecomp &t1,
+                                                    const PackedQDecomp &t2) {
+  PackedQDecomp res{};
+  res.resize(std::min(t1.depth, t2.depth));
+
+  bool constAbove = false;
+  for (auto w = res.words(); w-- > 0;) {
+    auto mask = res.levelMask(w);
+    auto cv1 = t1.cvWord(w) & mask;
+    auto cv2 = t2.cvWord(w) & mask;
+    auto p1 = t1.pWord(w) & mask;
+    auto p2 = t2.pWord(w) & mask;
+
+    auto p3 = p1 | p2;
+    auto cv3 = cv1 | cv2;
+    if (constAbove) {
+      cv3 = mask;
+    } else if (auto diff = (cv3 ^ cv1) | (cv3 ^ cv2) | (p3 ^ p1) | (p3 ^ p2);
+               diff != 0) {
+      cv3 |= (Word{1} << (std::bit_width(diff) - 1)) - 1;
+      constAbove = true;
+    }
+
+    res.setWords(w, cv3, p3);
+  }
+
+  return res;
+}
+
+constexpr bool testqual(const PackedQDecomp &t1, const PackedQDecomp &t2) {
+  auto t3 = PackedQDecomp::GetQCombined(t1, t2);
+  return t2.cvEquals(t3);
+}
+
+constexpr bool testqual(std::string_view sv1, std::string_view sv2) {
+  instrument::ScopedTimer timer{instrument::Timer::eTestqual};
+  instrument::count(instrument::Counter::eTestqual);
+  return testqual(PackedQDecomp::Get(tokenize(sv1)),
+                  PackedQDecomp::Get(tokenize(sv2)));
+}
+
+/* Exception-free testqual. The error offset is relative to whichever of the
+   two types failed to tokenize, sv1 being checked first. */
+constexpr std::expected<bool, TokenizeError> tryTestqual(std::string_view sv1,
+                                                         std::string_view sv2) {
+  instrument::ScopedTimer timer{instrument::Timer::eTestqual};
+  instrument::count(instrument::Counter::eTestqual);
+
+  auto tok1 = tryTokenize(sv1);
+  if (!tok1)
+    return std::unexpected{tok1.error()};
+  auto tok2 = tryTokenize(sv2);
+  if (!tok2)
+    return std::unexpected{tok2.error()};
+
+  return testqual(PackedQDecomp::Get(*tok1), PackedQDecomp::Get(*tok2));
+}
+
+/* A type spelling known at compile time, made by the _type literal. Plain
+   character arrays keep converting to std::string_view instead. */
+class TypeLiteral final {
+private:
+  std::string_view sv_;
+
+public:
+  consteval explicit TypeLiteral(std::string_view sv) : sv_(sv) {}
+
+  constexpr std::string_view view() const { return sv_; }
 };
 
-bool testqual(std::string_view sv1, std::string_view sv2);
+namespace literals {
+
+consteval TypeLiteral operator""_type(const char *str, std::size_t len) {
+  return TypeLiteral{std::string_view{str, len}};
+}
+
+} // namespace literals
+
+/* Always evaluated at compile time, malformed types fail the build:
+     using namespace l1::literals;
+     static_assert(l1::testqual("char **"_type, "char const *const *"_type));
+ */
+consteval bool testqual(TypeLiteral t1, TypeLiteral t2) {
+  return testqual(t1.view(), t2.view());
+}
 
 } // namespace l1
 
@@ -106,4 +358,13 @@ public:
   }
 };
 
+template <> class fmt::formatter<l1::PackedQDecomp> {
+public:
+  constexpr auto parse(format_parse_context &ctx) { return ctx.begin(); }
+  template <typename FormatContext>
+  constexpr auto format(l1::PackedQDecomp const &qd, FormatContext &ctx) const {
+    return format_to(ctx.out(), "{}", qd.unpack());
+  }
+};
+
 #endif // __L1_CONV_QUAL_CONV_QUAL_HH__
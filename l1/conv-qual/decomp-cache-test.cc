@@ -0,0 +1,123 @@
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "decomp-cache.hh"
+
+using namespace l1;
+
+TEST(DecompCache, Normalize) {
+  std::vector<std::pair<std::string, std::string>> samples{
+      {"char", "char"},
+      {"  char\t", "char"},
+      {"char * const", "char*const"},
+      {"char\n*\n*", "char**"},
+      {"char [] ", "char[]"},
+      {"char [ ]", "char[ ]"},
+      {"char [\t\t] *", "char[ ]*"},
+      {"const   char", "const char"},
+      {"char  const * const\t*", "char const*const*"},
+  };
+
+  for (const auto &[type, expected] : samples) {
+    std::string key{};
+    DecompCache::normalize(type, key);
+    EXPECT_EQ(key, expected) << type;
+  }
+}
+
+TEST(DecompCache, HitsAndMisses) {
+  DecompCache cache{};
+
+  EXPECT_EQ(cache.get("char **"), PackedQDecomp::Get(tokenize("char **")));
+  EXPECT_EQ(cache.get("char**"), PackedQDecomp::Get(tokenize("char **")));
+  EXPECT_EQ(cache.get(" char * * "), PackedQDecomp::Get(tokenize("char **")));
+  EXPECT_EQ(cache.get("char *const"),
+            PackedQDecomp::Get(tokenize("char *const")));
+
+  auto counters = cache.decompCounters();
+  EXPECT_EQ(counters.hits, 2u);
+  EXPECT_EQ(counters.misses, 2u);
+  EXPECT_EQ(counters.size, 2u);
+
+  EXPECT_THROW(cache.get("constchar"), std::runtime_error);
+  EXPECT_THROW(cache.get("constchar"), std::runtime_error);
+  EXPECT_EQ(cache.decompCounters().size, 2u);
+
+  cache.clear();
+  EXPECT_EQ(cache.decompCounters().misses, 0u);
+  EXPECT_EQ(cache.decompCounters().size, 0u);
+}
+
+TEST(DecompCache, MalformedAfterValidSpelling) {
+  DecompCache cache{64, 64};
+
+  EXPECT_EQ(cache.get("char[]"), PackedQDecomp::Get(tokenize("char[]")));
+  EXPECT_THROW(cache.get("char [ ]"), std::runtime_error);
+  EXPECT_TRUE(cache.testqual("char[]", "char const *"));
+  EXPECT_THROW(cache.testqual("char [ ]", "char const *"), std::runtime_error);
+}
+
+TEST(DecompCache, Eviction) {
+  DecompCache cache{4, 0, 1};
+
+  std::string type = "char";
+  for (int i = 0; i < 10; ++i) {
+    type += " *";
+    cache.get(type);
+  }
+
+  auto counters = cache.decompCounters();
+  EXPECT_EQ(counters.size, 4u);
+  EXPECT_EQ(counters.evictions, 6u);
+
+  // The most recent entries survive.
+  cache.get(type);
+  EXPECT_EQ(cache.decompCounters().hits, 1u);
+  cache.get("char *");
+  EXPECT_EQ(cache.decompCounters().misses, 11u);
+}
+
+TEST(DecompCache, Verdicts) {
+  DecompCache cache{64, 64};
+  std::vector<std::pair<std::string, std::string>> pairs{
+      {"char **", "char const *const *"},
+      {"char **", "char const **"},
+      {"char[]", "char *"},
+      {"char *const *", "char **"},
+  };
+
+  for (int round = 0; round < 3; ++round)
+    for (const auto &[from, to] : pairs)
+      EXPECT_EQ(cache.testqual(from, to), testqual(from, to))
+          << from << " -> " << to;
+
+  auto counters = cache.verdictCounters();
+  EXPECT_EQ(counters.misses, pairs.size());
+  EXPECT_EQ(counters.hits, 2 * pairs.size());
+}
+
+TEST(DecompCache, Concurrent) {
+  DecompCache cache{16, 16, 4};
+  std::vector<std::string> types{"char",         "char *",       "char **",
+                                 "char const *", "char *const *", "char[]",
+                                 "char *[]",     "char const **"};
+
+  std::vector<std::jthread> threads{};
+  for (int t = 0; t < 4; ++t)
+    threads.emplace_back([&] {
+      for (int i = 0; i < 2000; ++i)
+        for (const auto &from : types) {
+          const auto &to = types[static_cast<std::size_t>(i) % types.size()];
+          ASSERT_EQ(cache.testqual(from, to), testqual(from, to));
+        }
+    });
+  threads.clear();
+
+  auto counters = cache.verdictCounters();
+  EXPECT_EQ(counters.hits + counters.misses, 4u * 2000u * types.size());
+  EXPECT_LE(counters.size, 16u);
+}
@@ -0,0 +1,65 @@
+#include <cctype>
+#include <string>
+
+#include "decomp-cache.hh"
+#include "tokenizing.hh"
+
+namespace l1 {
+
+DecompCache::DecompCache(std::size_t capacity, std::size_t verdictCapacity,
+                         std::size_t shards)
+    : decomps_(capacity, shards) {
+  if (verdictCapacity != 0)
+    verdicts_.emplace(verdictCapacity, shards);
+}
+
+void DecompCache::normalize(std::string_view type, std::string &out) {
+  auto isPunct = [](char c) { return c == '*' || c == '[' || c == ']'; };
+
+  bool space = false;
+  for (auto c : type) {
+    if (std::isspace(static_cast<unsigned char>(c))) {
+      space = true;
+      continue;
+    }
+
+    // "[ ]" does not tokenize, so it must not share the key of "[]".
+    if (space && !out.empty() &&
+        ((!isPunct(out.back()) && !isPunct(c)) ||
+         (out.back() == '[' && c == ']')))
+      out += ' ';
+    space = false;
+    out += c;
+  }
+}
+
+PackedQDecomp DecompCache::get(std::string_view type) {
+  thread_local std::string key{};
+  key.clear();
+  normalize(type, key);
+
+  return decomps_.getOrInsert(
+      key, [&] { return PackedQDecomp::Get(l1::tokenize(type)); });
+}
+
+bool DecompCache::testqual(std::string_view from, std::string_view to) {
+  if (!verdicts_)
+    return l1::testqual(get(from), get(to));
+
+  thread_local std::string key{};
+  key.clear();
+  normalize(from, key);
+  key += '\t';
+  normalize(to, key);
+
+  return verdicts_->getOrInsert(
+      key, [&] { return l1::testqual(get(from), get(to)); });
+}
+
+void DecompCache::clear() {
+  decomps_.clear();
+  if (verdicts_)
+    verdicts_->clear();
+}
+
+} // namespace l1
@@ -0,0 +1,149 @@
+#ifndef __L1_CONV_QUAL_DECOMP_CACHE_HH__
+#define __L1_CONV_QUAL_DECOMP_CACHE_HH__
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "conv-qual.hh"
+
+namespace l1 {
+
+struct CacheCounters final {
+  std::size_t hits = 0;
+  std::size_t misses = 0;
+  std::size_t evictions = 0;
+  std::size_t size = 0;
+
+  CacheCounters &operator+=(const CacheCounters &other) {
+    hits += other.hits;
+    misses += other.misses;
+    evictions += other.evictions;
+    size += other.size;
+    return *this;
+  }
+};
+
+/* String-keyed LRU split into independently locked shards. Lookups by
+   std::string_view do not allocate: the index refers to the keys stored in
+   the list nodes. The value is built outside of the lock, so two threads
+   missing on the same key may both build it; the first insert wins. */
+template <typename Value> class ShardedLru final {
+private:
+  using Entries = std::list<std::pair<std::string, Value>>;
+
+  struct Shard final {
+    std::mutex mutex{};
+    Entries entries{}; // most recently used first
+    std::unordered_map<std::string_view, typename Entries::iterator> index{};
+    CacheCounters counters{};
+  };
+
+  std::size_t shardCapacity_ = 1;
+  std::vector<std::unique_ptr<Shard>> shards_{};
+
+  Shard &shardOf(std::string_view key) const {
+    return *shards_[std::hash<std::string_view>{}(key) % shards_.size()];
+  }
+
+public:
+  ShardedLru(std::size_t capacity, std::size_t shards) {
+    shards = std::max<std::size_t>(shards, 1);
+    shardCapacity_ = std::max<std::size_t>((capacity + shards - 1) / shards, 1);
+    for (std::size_t i = 0; i < shards; ++i)
+      shards_.push_back(std::make_unique<Shard>());
+  }
+
+  template <typename Make>
+  Value getOrInsert(std::string_view key, Make &&make) {
+    auto &shard = shardOf(key);
+    {
+      std::lock_guard lock{shard.mutex};
+      if (auto it = shard.index.find(key); it != shard.index.end()) {
+        ++shard.counters.hits;
+        shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+        return it->second->second;
+      }
+      ++shard.counters.misses;
+    }
+
+    Value value = std::forward<Make>(make)();
+
+    std::lock_guard lock{shard.mutex};
+    if (auto it = shard.index.find(key); it != shard.index.end())
+      return it->second->second;
+
+    shard.entries.emplace_front(std::string{key}, value);
+    shard.index.emplace(shard.entries.front().first, shard.entries.begin());
+    if (shard.entries.size() > shardCapacity_) {
+      shard.index.erase(shard.entries.back().first);
+      shard.entries.pop_back();
+      ++shard.counters.evictions;
+    }
+    return value;
+  }
+
+  CacheCounters counters() const {
+    CacheCounters res{};
+    for (const auto &shard : shards_) {
+      std::lock_guard lock{shard->mutex};
+      auto counters = shard->counters;
+      counters.size = shard->entries.size();
+      res += counters;
+    }
+    return res;
+  }
+
+  void clear() {
+    for (auto &shard : shards_) {
+      std::lock_guard lock{shard->mutex};
+      shard->index.clear();
+      shard->entries.clear();
+      shard->counters = {};
+    }
+  }
+};
+
+/* Memoizes PackedQDecomp::Get(tokenize(type)) by normalized type spelling
+   and, when verdictCapacity is not zero, whole testqual verdicts by the
+   normalized pair. Malformed types are not cached: their exceptions reach
+   the caller every time. Safe to share between threads. */
+class DecompCache final {
+private:
+  ShardedLru<PackedQDecomp> decomps_;
+  std::optional<ShardedLru<bool>> verdicts_{};
+
+public:
+  explicit DecompCache(std::size_t capacity = 4096,
+                       std::size_t verdictCapacity = 0,
+                       std::size_t shards = 16);
+
+  PackedQDecomp get(std::string_view type);
+  bool testqual(std::string_view from, std::string_view to);
+
+  CacheCounters decompCounters() const { return decomps_.counters(); }
+  CacheCounters verdictCounters() const {
+    return verdicts_ ? verdicts_->counters() : CacheCounters{};
+  }
+
+  void clear();
+
+  /* Appends type to out with whitespace runs collapsed into one space and
+     no whitespace at the ends or next to '*', '[' and ']', except inside
+     "[ ]". Spellings which tokenize the same way mostly map to the same key
+     this way, and no malformed spelling shares the key of a valid one. */
+  static void normalize(std::string_view type, std::string &out);
+};
+
+} // namespace l1
+
+#endif // __L1_CONV_QUAL_DECOMP_CACHE_HH__
@@ -0,0 +1,108 @@
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "push-tokenizer.hh"
+
+using namespace l1;
+using namespace std::literals;
+
+namespace {
+
+const std::vector<std::string_view> kLines{
+    "char",          "char * const", "\tchar\t[]",   "const char",
+    "char const **", "char*const*",  "char *const *[]",
+    "constchar",     "charconst*",   "char[]const",  "char [] []",
+    "char const*x",  "cons",         "c",            "ch ar",
+    "* char",        "char[",        "[] char",      "const",
+};
+
+std::vector<Declaration> expected(const std::vector<std::string_view> &lines) {
+  std::vector<Declaration> res{};
+  for (std::size_t i = 0; i < lines.size(); ++i)
+    res.push_back({i, tryTokenize(lines[i])});
+  return res;
+}
+
+void expectSame(const std::vector<Declaration> &actual,
+                const std::vector<Declaration> &expected) {
+  ASSERT_EQ(actual.size(), expected.size());
+  for (std::size_t i = 0; i < actual.size(); ++i) {
+    EXPECT_EQ(actual[i].line, expected[i].line);
+    EXPECT_EQ(actual[i].tokens, expected[i].tokens) << kLines[i];
+  }
+}
+
+} // namespace
+
+TEST(PushTokenizer, SameAsTokenize) {
+  for (auto line : kLines) {
+    PushTokenizer<DeclarationCollector> tokenizer{};
+    tokenizer.feed(line);
+    tokenizer.finish();
+
+    const auto &decls = tokenizer.sink().declarations();
+    ASSERT_EQ(decls.size(), 1u) << line;
+    EXPECT_EQ(decls[0].tokens, tryTokenize(line)) << line;
+  }
+}
+
+TEST(PushTokenizer, AnyChunking) {
+  std::string stream{};
+  for (auto line : kLines) {
+    stream += line;
+    stream += '\n';
+  }
+  auto reference = expected(kLines);
+
+  for (std::size_t chunk = 1; chunk <= 16; ++chunk) {
+    PushTokenizer<DeclarationCollector> tokenizer{};
+    for (std::size_t pos = 0; pos < stream.size(); pos += chunk)
+      tokenizer.feed(std::string_view{stream}.substr(pos, chunk));
+    tokenizer.finish();
+
+    expectSame(tokenizer.sink().declarations(), reference);
+  }
+}
+
+TEST(PushTokenizer, SplitKeywords) {
+  PushTokenizer<DeclarationCollector> tokenizer{};
+  for (auto chunk : {"con"sv, "st ch"sv, "ar"sv, " *"sv, "co"sv, "nst ["sv,
+                     "]\n\nch"sv, "ar"sv})
+    tokenizer.feed(chunk);
+  tokenizer.finish();
+
+  auto decls = tokenizer.sink().take();
+  ASSERT_EQ(decls.size(), 2u);
+  EXPECT_EQ(decls[0].line, 0u);
+  EXPECT_EQ(decls[0].tokens, tryTokenize("const char *const []"));
+  EXPECT_EQ(decls[1].line, 2u);
+  EXPECT_EQ(decls[1].tokens, tryTokenize("char"));
+}
+
+TEST(PushTokenizer, EmitsEarly) {
+  struct Counter final {
+    std::size_t tokens = 0;
+    std::size_t declarations = 0;
+
+    void token(Token) { ++tokens; }
+    void declaration(std::size_t) { ++declarations; }
+    void error(std::size_t, const TokenizeError &) {}
+  };
+
+  PushTokenizer<Counter> tokenizer{};
+  tokenizer.feed("char");
+  EXPECT_EQ(tokenizer.sink().tokens, 0u);
+  tokenizer.feed(" *");
+  EXPECT_EQ(tokenizer.sink().tokens, 2u); // char non-const
+  tokenizer.feed("co");
+  tokenizer.feed("nst *");
+  EXPECT_EQ(tokenizer.sink().tokens, 4u); // * const
+  EXPECT_EQ(tokenizer.sink().declarations, 0u);
+  tokenizer.feed("\n");
+  EXPECT_EQ(tokenizer.sink().tokens, 6u); // * non-const
+  EXPECT_EQ(tokenizer.sink().declarations, 1u);
+}
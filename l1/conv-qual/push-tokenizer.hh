@@ -0,0 +1,236 @@
+#ifndef __L1_CONV_QUAL_PUSH_TOKENIZER_HH__
+#define __L1_CONV_QUAL_PUSH_TOKENIZER_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "tokenizing.hh"
+
+namespace l1 {
+
+/* Receives the output of PushTokenizer. token() is called as soon as an
+   output token is known, declaration() or error() when a declaration ends.
+   Tokens of a declaration which then fails were already passed to token(),
+   the sink has to drop them on error(). */
+template <typename Sink>
+concept TokenSink = requires(Sink &sink, Token token, std::size_t line,
+                             const TokenizeError &error) {
+  sink.token(token);
+  sink.declaration(line);
+  sink.error(line, error);
+};
+
+/* Resumable version of tokenize(). Input comes in arbitrary chunks through
+   feed(), every line is a separate declaration and finish() ends the last
+   one. The DFA state and a partially read keyword ("con|st", "ch|ar") are
+   kept between chunks, so nothing has to be stitched together by the
+   caller. For every line the sink sees exactly what tryTokenize() returns
+   for it; error offsets are relative to the start of the line. Lines
+   without any words are skipped. */
+template <TokenSink Sink> class PushTokenizer final {
+private:
+  enum class Phase : std::uint8_t { eWordStart, eAfterChar, eRest };
+
+  // Adapts the sink to detail::updateState.
+  struct Emitter final {
+    Sink &sink;
+    Token &last;
+
+    void push_back(Token token) {
+      last = token;
+      sink.token(token);
+    }
+    Token back() const { return last; }
+  };
+
+  Sink sink_;
+
+  State state_ = State::eStart;
+  Token last_ = Token::eEOF;
+  Phase phase_ = Phase::eWordStart;
+  bool inWord_ = false;
+  bool sawWord_ = false;
+
+  /* Keyword being matched. "c" at the start of a word may be both "char"
+     and "const", so keyword_ stays empty until the second letter. */
+  std::string_view keyword_{};
+  bool charOrConst_ = false;
+  std::size_t matched_ = 0;
+  std::uint32_t keywordStart_ = 0;
+
+  std::uint32_t offset_ = 0;
+  std::size_t line_ = 0;
+
+  bool failed_ = false;
+  TokenizeError error_{};
+
+  void fail(TokenizeErrc kind, Token token, std::uint32_t offset) {
+    failed_ = true;
+    error_ = {.kind = kind, .state = state_, .token = token, .offset = offset};
+  }
+
+  void step(Token token, std::uint32_t offset) {
+    auto next = detail::nextState(state_, token);
+    if (next == State::eInvalid)
+      return fail(TokenizeErrc::eUnknownTransition, token, offset);
+
+    Emitter emitter{sink_, last_};
+    detail::updateState(emitter, state_, next);
+    state_ = next;
+  }
+
+  void startKeyword(std::string_view keyword) {
+    keyword_ = keyword;
+    matched_ = 1;
+    keywordStart_ = offset_;
+  }
+
+  void endWord() {
+    inWord_ = false;
+    if (charOrConst_ || !keyword_.empty())
+      fail(TokenizeErrc::eUnknownToken, Token::eEOF, keywordStart_);
+  }
+
+  void lexChar(char c) {
+    using namespace std::literals;
+
+    if (charOrConst_) {
+      charOrConst_ = false;
+      if (c == 'h')
+        keyword_ = "char"sv;
+      else if (c == 'o')
+        keyword_ = "const"sv;
+      else
+        return fail(TokenizeErrc::eUnknownToken, Token::eEOF, keywordStart_);
+      matched_ = 2;
+      return;
+    }
+
+    if (!keyword_.empty()) {
+      if (c != keyword_[matched_])
+        return fail(TokenizeErrc::eUnknownToken, Token::eEOF, keywordStart_);
+      if (++matched_ != keyword_.size())
+        return;
+
+      auto keyword = std::exchange(keyword_, {});
+      if (keyword == "char"sv) {
+        phase_ = Phase::eAfterChar;
+        return step(Token::eChar, keywordStart_);
+      }
+      phase_ = Phase::eRest;
+      return step(keyword == "const"sv ? Token::eConst : Token::eArr,
+                  keywordStart_);
+    }
+
+    keywordStart_ = offset_;
+    if (c == '*') {
+      phase_ = Phase::eRest;
+      return step(Token::ePtr, offset_);
+    }
+    if (c == '[')
+      return startKeyword("[]"sv);
+
+    if (c == 'c' && phase_ == Phase::eWordStart) {
+      charOrConst_ = true;
+      return;
+    }
+    if (c == 'c' && phase_ == Phase::eRest)
+      return startKeyword("const"sv);
+
+    fail(TokenizeErrc::eUnknownToken, Token::eEOF, offset_);
+  }
+
+  void endDeclaration() {
+    if (inWord_ && !failed_)
+      endWord();
+
+    if (failed_) {
+      sink_.error(line_, error_);
+    } else if (sawWord_) {
+      Emitter emitter{sink_, last_};
+      detail::updateState(emitter, state_, State::eFinish);
+      sink_.declaration(line_);
+    }
+
+    state_ = State::eStart;
+    last_ = Token::eEOF;
+    inWord_ = sawWord_ = failed_ = charOrConst_ = false;
+    keyword_ = {};
+    offset_ = 0;
+  }
+
+public:
+  template <typename... Args>
+  explicit PushTokenizer(Args &&...args) : sink_(std::forward<Args>(args)...) {}
+
+  Sink &sink() { return sink_; }
+  const Sink &sink() const { return sink_; }
+
+  void feed(std::string_view chunk) {
+    for (auto c : chunk) {
+      if (c == '\n') {
+        endDeclaration();
+        ++line_;
+        continue;
+      }
+
+      if (!failed_) {
+        if (detail::isSpace(c)) {
+          if (inWord_)
+            endWord();
+        } else {
+          if (!inWord_) {
+            inWord_ = sawWord_ = true;
+            phase_ = Phase::eWordStart;
+          }
+          lexChar(c);
+        }
+      }
+      ++offset_;
+    }
+  }
+
+  // Ends the last declaration, which does not need a trailing newline.
+  void finish() {
+    if (sawWord_ || failed_)
+      endDeclaration();
+  }
+};
+
+struct Declaration final {
+  std::size_t line;
+  std::expected<std::vector<Token>, TokenizeError> tokens;
+};
+
+/* Sink which gathers whole declarations. */
+class DeclarationCollector final {
+private:
+  std::vector<Token> current_{};
+  std::vector<Declaration> declarations_{};
+
+public:
+  void token(Token token) { current_.push_back(token); }
+
+  void declaration(std::size_t line) {
+    declarations_.push_back({line, std::move(current_)});
+    current_.clear();
+  }
+
+  void error(std::size_t line, const TokenizeError &error) {
+    declarations_.push_back({line, std::unexpected{error}});
+    current_.clear();
+  }
+
+  const std::vector<Declaration> &declarations() const {
+    return declarations_;
+  }
+  std::vector<Declaration> take() { return std::exchange(declarations_, {}); }
+};
+
+} // namespace l1
+
+#endif // __L1_CONV_QUAL_PUSH_TOKENIZER_HH__
@@ -1,4 +1,5 @@
 #include <stdexcept>
+#include <string_view>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -61,6 +62,18 @@ TEST(Tokenizing, Correct) {
   for (const auto &[type, tokens] : samples)
     EXPECT_EQ(tokens, tokenize(type));
 }
+
+static_assert(tokenize("char") == std::vector{Token::eChar, Token::eNonConst});
+static_assert(tokenize("const char") ==
+              std::vector{Token::eChar, Token::eConst});
+static_assert(tokenize("char * const") == std::vector{Token::eChar,
+                                                       Token::eNonConst,
+                                                       Token::ePtr,
+                                                       Token::eConst});
+static_assert(tokenize("\tchar\t[]") == std::vector{Token::eChar,
+                                                     Token::eNonConst,
+                                                     Token::eArr,
+                                                     Token::eNonConst});
 using t = const char[];
 TEST(Tokenizing, Incorrect) {
   std::vector<std::string> types{
@@ -74,5 +87,66 @@ TEST(Tokenizing, Incorrect) {
   for (const auto &type : types) {
     fmt::println("{}", type);
     ASSERT_THROW(tokenize(type), std::runtime_error);
+
+    auto tokens = tryTokenize(type);
+    ASSERT_FALSE(tokens.has_value());
+    EXPECT_LT(tokens.error().offset, type.size());
+  }
+}
+
+TEST(Tokenizing, Expected) {
+  for (std::string_view type : {"char", "char * const", "\tchar\t[]",
+                                "const char", "char const **"}) {
+    auto tokens = tryTokenize(type);
+    ASSERT_TRUE(tokens.has_value()) << type;
+    EXPECT_EQ(*tokens, tokenize(type));
   }
 }
+
+TEST(Tokenizing, ErrorPositions) {
+  struct Sample final {
+    std::string_view type;
+    TokenizeError error;
+    std::string_view message;
+  };
+
+  std::vector<Sample> samples{
+      {"constchar",
+       {TokenizeErrc::eUnknownToken, State::eConst0, Token::eEOF, 5},
+       "Unknown token in: constchar"},
+      {" constchar ",
+       {TokenizeErrc::eUnknownToken, State::eConst0, Token::eEOF, 6},
+       "Unknown token in: constchar"},
+      {"char const*x",
+       {TokenizeErrc::eUnknownToken, State::ePtr, Token::eEOF, 11},
+       "Unknown token in: const*x"},
+      {"char[]const",
+       {TokenizeErrc::eUnknownTransition, State::eArr, Token::eConst, 6},
+       "Unknown transition from eArr by const"},
+      {"char [] []",
+       {TokenizeErrc::eUnknownTransition, State::eArr, Token::eArr, 8},
+       "Unknown transition from eArr by []"},
+  };
+
+  for (const auto &[type, error, message] : samples) {
+    auto tokens = tryTokenize(type);
+    ASSERT_FALSE(tokens.has_value()) << type;
+    EXPECT_EQ(tokens.error(), error) << type;
+    EXPECT_EQ(errorMessage(tokens.error(), type), message);
+
+    try {
+      tokenize(type);
+      ADD_FAILURE() << type;
+    } catch (const std::runtime_error &e) {
+      EXPECT_EQ(e.what(), message);
+    }
+  }
+
+  EXPECT_EQ(fmt::format("{}", samples[0].error), "Unknown token at offset 5");
+  EXPECT_EQ(fmt::format("{}", samples[3].error),
+            "Unknown transition from eArr by const at offset 6");
+}
+
+static_assert(tryTokenize("char[]const").error() ==
+              TokenizeError{TokenizeErrc::eUnknownTransition, State::eArr,
+                            Token::eConst, 6});
@@ -1,15 +1,21 @@
 #ifndef __L1_CONV_QUAL_TOKENIZING_HH__
 #define __L1_CONV_QUAL_TOKENIZING_HH__
 
+#include <array>
 #include <cstdint>
+#include <expected>
 #include <iterator>
+#include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include <fmt/base.h>
 #include <fmt/format.h>
 #include <range/v3/all.hpp>
 
+#include "l1/instrument/instrument.hh"
+
 namespace l1 {
 
 namespace rng = ranges;
@@ -17,7 +23,235 @@ namespace vws = rng::views;
 
 enum class Token : std::uint8_t { eConst, eChar, eArr, ePtr, eNonConst, eEOF };
 
-std::vector<Token> tokenize(std::string_view sv);
+enum class State : std::uint8_t {
+  eInvalid,
+  eStart,
+  eFinish,
+  eChar,
+  eConst0,
+  eConstChar,
+  eArr,
+  ePtr,
+  ePtrConst
+};
+
+enum class TokenizeErrc : std::uint8_t { eUnknownToken, eUnknownTransition };
+
+/* Where and why tokenizing failed. offset is the byte offset into the
+   input: the start of the unrecognized text for eUnknownToken, the start
+   of the token which has no transition from state for eUnknownTransition.
+   No text is built until the error gets formatted. */
+struct TokenizeError final {
+  TokenizeErrc kind;
+  State state;
+  Token token;
+  std::uint32_t offset;
+
+  constexpr bool operator==(const TokenizeError &) const = default;
+};
+
+/* The message of the throwing API, e.g. "Unknown token in: constchar".
+   Needs the input to quote the offending word. */
+std::string errorMessage(const TokenizeError &error, std::string_view input);
+
+/* Not constexpr on purpose: reaching it during constant evaluation makes
+   the whole expression ill-formed, so bad input is reported at build
+   time. */
+[[noreturn]] void throwTokenizeError(const TokenizeError &error,
+                                     std::string_view input);
+
+namespace detail {
+
+inline constexpr std::size_t kTokens = std::to_underlying(Token::eEOF) + 1;
+inline constexpr std::size_t kStates = std::to_underlying(State::ePtrConst) + 1;
+
+// Missing transitions are State::eInvalid.
+inline constexpr auto kTransitions = [] {
+  std::array<std::array<State, kTokens>, kStates> table{};
+  auto set = [&](State from, Token by, State to) {
+    table[std::to_underlying(from)][std::to_underlying(by)] = to;
+  };
+
+  set(State::eStart, Token::eChar, State::eChar);
+  set(State::eStart, Token::eConst, State::eConst0);
+
+  set(State::eConst0, Token::eChar, State::eConstChar);
+
+  set(State::eChar, Token::eArr, State::eArr);
+  set(State::eChar, Token::ePtr, State::ePtr);
+  set(State::eChar, Token::eConst, State::eConstChar);
+  set(State::eChar, Token::eEOF, State::eFinish);
+
+  set(State::eConstChar, Token::eArr, State::eArr);
+  set(State::eConstChar, Token::ePtr, State::ePtr);
+  set(State::eConstChar, Token::eEOF, State::eFinish);
+
+  set(State::ePtr, Token::eConst, State::ePtrConst);
+  set(State::ePtr, Token::ePtr, State::ePtr);
+  set(State::ePtr, Token::eArr, State::eArr);
+  set(State::ePtr, Token::eEOF, State::eFinish);
+
+  set(State::ePtrConst, Token::ePtr, State::ePtr);
+  set(State::ePtrConst, Token::eArr, State::eArr);
+  set(State::ePtrConst, Token::eEOF, State::eFinish);
+
+  set(State::eArr, Token::eEOF, State::eFinish);
+  return table;
+}();
+
+constexpr bool isSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' ||
+         c == '\r';
+}
+
+constexpr State nextState(State from, Token by) {
+  return kTransitions[std::to_underlying(from)][std::to_underlying(by)];
+}
+
+/* Emits the output tokens of the from -> to transition. Tokens is anything
+   with push_back() and back(), usually std::vector<Token>. */
+template <typename Tokens>
+constexpr void updateState(Tokens &tokens, State from, State to) {
+  if (from == State::eConstChar &&
+      (to == State::eFinish || to == State::eArr || to == State::ePtr)) {
+    tokens.push_back(Token::eChar);
+    tokens.push_back(Token::eConst);
+  } else if (from == State::eChar &&
+             (to == State::eArr || to == State::ePtr || to == State::eFinish)) {
+    tokens.push_back(Token::eChar);
+    tokens.push_back(Token::eNonConst);
+  } else if (from == State::eArr && to == State::eFinish) {
+    auto cv = tokens.back();
+    tokens.push_back(Token::eArr);
+    tokens.push_back(cv);
+  } else if (from == State::ePtr &&
+             (to == State::ePtr || to == State::eArr || to == State::eFinish)) {
+    tokens.push_back(Token::ePtr);
+    tokens.push_back(Token::eNonConst);
+  } else if (from == State::ePtrConst &&
+             (to == State::ePtr || to == State::eArr || to == State::eFinish)) {
+    tokens.push_back(Token::ePtr);
+    tokens.push_back(Token::eConst);
+  }
+}
+
+/* Splits one whitespace-free word starting at offset into input tokens and
+   feeds them to step, which advances state. "char" may only start a word
+   and is either the whole word or followed by "*" or "[]". */
+template <typename Step>
+constexpr std::expected<void, TokenizeError>
+str2tok(std::string_view word, std::uint32_t offset, const State &state,
+        Step &&step) {
+  using namespace std::literals;
+
+  auto rest = word;
+  auto at = [&] {
+    return offset + static_cast<std::uint32_t>(word.size() - rest.size());
+  };
+  auto unknown = [&] {
+    return std::unexpected{TokenizeError{.kind = TokenizeErrc::eUnknownToken,
+                                         .state = state,
+                                         .token = Token::eEOF,
+                                         .offset = at()}};
+  };
+
+  if (rest.starts_with("char"sv)) {
+    if (auto res = step(Token::eChar, at()); !res)
+      return res;
+    rest.remove_prefix(4);
+    if (rest.empty())
+      return {};
+
+    if (rest.starts_with("*"sv)) {
+      if (auto res = step(Token::ePtr, at()); !res)
+        return res;
+      rest.remove_prefix(1);
+    } else if (rest.starts_with("[]"sv)) {
+      if (auto res = step(Token::eArr, at()); !res)
+        return res;
+      rest.remove_prefix(2);
+    } else {
+      return unknown();
+    }
+  }
+
+  while (!rest.empty()) {
+    std::expected<void, TokenizeError> res{};
+    if (rest.starts_with("const"sv)) {
+      res = step(Token::eConst, at());
+      rest.remove_prefix(5);
+    } else if (rest.starts_with("[]"sv)) {
+      res = step(Token::eArr, at());
+      rest.remove_prefix(2);
+    } else if (rest.starts_with("*"sv)) {
+      res = step(Token::ePtr, at());
+      rest.remove_prefix(1);
+    } else {
+      return unknown();
+    }
+    if (!res)
+      return res;
+  }
+
+  return {};
+}
+
+} // namespace detail
+
+/* Output is [char, cv, P1, cv1, ..., Pn, cvn]: the base type and its cv
+   followed by every declarator with its own cv, innermost first. */
+constexpr std::expected<std::vector<Token>, TokenizeError>
+tryTokenize(std::string_view sv) {
+  instrument::ScopedTimer timer{instrument::Timer::eTokenize};
+  instrument::count(instrument::Counter::eTokenize);
+
+  std::vector<Token> tokens{};
+  auto state = State::eStart;
+  auto step = [&](Token token,
+                  std::uint32_t offset) -> std::expected<void, TokenizeError> {
+    auto next = detail::nextState(state, token);
+    if (next == State::eInvalid)
+      return std::unexpected{
+          TokenizeError{.kind = TokenizeErrc::eUnknownTransition,
+                        .state = state,
+                        .token = token,
+                        .offset = offset}};
+
+    detail::updateState(tokens, state, next);
+    state = next;
+    return {};
+  };
+
+  for (std::size_t pos = 0;;) {
+    while (pos < sv.size() && detail::isSpace(sv[pos]))
+      ++pos;
+    if (pos == sv.size())
+      break;
+
+    auto end = pos;
+    while (end < sv.size() && !detail::isSpace(sv[end]))
+      ++end;
+
+    auto res = detail::str2tok(sv.substr(pos, end - pos),
+                               static_cast<std::uint32_t>(pos), state, step);
+    if (!res) {
+      instrument::count(instrument::Counter::eTokenizeErrors);
+      return std::unexpected{res.error()};
+    }
+    pos = end;
+  }
+
+  detail::updateState(tokens, state, State::eFinish);
+  return tokens;
+}
+
+// Throwing wrapper over tryTokenize.
+constexpr std::vector<Token> tokenize(std::string_view sv) {
+  auto tokens = tryTokenize(sv);
+  if (!tokens)
+    throwTokenizeError(tokens.error(), sv);
+  return std::move(*tokens);
+}
 
 } // namespace l1
 
@@ -54,4 +288,79 @@ public:
   }
 };
 
+template <>
+struct fmt::formatter<l1::State> : fmt::formatter<fmt::string_view> {
+public:
+  template <typename FormatContext>
+  auto format(l1::State state, FormatContext &ctx) const {
+    fmt::string_view name{};
+    switch (state) {
+    case l1::State::eInvalid:
+      name = "eInvalid";
+      break;
+    case l1::State::eStart:
+      name = "eStart";
+      break;
+    case l1::State::eFinish:
+      name = "eFinish";
+      break;
+    case l1::State::eChar:
+      name = "eChar";
+      break;
+    case l1::State::eConst0:
+      name = "eConst0";
+      break;
+    case l1::State::eConstChar:
+      name = "eConstChar";
+      break;
+    case l1::State::eArr:
+      name = "eArr";
+      break;
+    case l1::State::ePtr:
+      name = "ePtr";
+      break;
+    case l1::State::ePtrConst:
+      name = "ePtrConst";
+      break;
+    default:
+      name = "UNKNOWN";
+      break;
+    }
+    return fmt::formatter<fmt::string_view>::format(name, ctx);
+  }
+};
+
+template <>
+struct fmt::formatter<l1::TokenizeErrc> : fmt::formatter<fmt::string_view> {
+public:
+  template <typename FormatContext>
+  auto format(l1::TokenizeErrc errc, FormatContext &ctx) const {
+    fmt::string_view name{};
+    switch (errc) {
+    case l1::TokenizeErrc::eUnknownToken:
+      name = "Unknown token";
+      break;
+    case l1::TokenizeErrc::eUnknownTransition:
+      name = "Unknown transition";
+      break;
+    default:
+      name = "UNKNOWN";
+      break;
+    }
+    return fmt::formatter<fmt::string_view>::format(name, ctx);
+  }
+};
+
+template <> class fmt::formatter<l1::TokenizeError> {
+public:
+  constexpr auto parse(format_parse_context &ctx) { return ctx.begin(); }
+  template <typename FormatContext>
+  auto format(l1::TokenizeError const &error, FormatContext &ctx) const {
+    if (error.kind == l1::TokenizeErrc::eUnknownTransition)
+      return format_to(ctx.out(), "{} from {} by {} at offset {}", error.kind,
+                       error.state, error.token, error.offset);
+    return format_to(ctx.out(), "{} at offset {}", error.kind, error.offset);
+  }
+};
+
 #endif // __L1_CONV_QUAL_TOKENIZING_HH__
@@ -7,6 +7,8 @@
 
 #include <range/v3/all.hpp>
 
+#include "l1/instrument/instrument.hh"
+
 namespace l1 {
 
 namespace rng = ranges;
@@ -37,8 +39,13 @@ public:
 
 private:
   void detach() {
-    if (!str_.unique())
+    if (!str_.unique()) {
+      instrument::ScopedTimer timer{instrument::Timer::eCowDetach};
+      instrument::count(instrument::Counter::eCowDetach);
+      instrument::count(instrument::Counter::eCowDetachBytes,
+                        str_->size() * sizeof(CharT));
       str_ = std::make_shared<StringT>(*str_);
+    }
   }
 
 public:
@@ -87,6 +94,7 @@ public:
       : delim_(delim), str_(str), begin_(0) {}
 
   auto get() {
+    instrument::count(instrument::Counter::eCowTokenizerGet);
     StringViewT str = str_.data();
     auto begin = str.find_first_not_of(delim_, begin_);
     if (begin == str.npos)
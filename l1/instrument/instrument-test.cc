@@ -0,0 +1,120 @@
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "instrument.hh"
+#include "l1/conv-qual/conv-qual.hh"
+#include "l1/conv-qual/tokenizing.hh"
+#include "l1/cow/cow.hh"
+#include "l1/twine/twine.hh"
+
+using namespace l1;
+using instrument::Counter;
+using instrument::Timer;
+
+static_assert(instrument::kEnabled);
+
+// Hooks are skipped during constant evaluation.
+static_assert(testqual("char **", "char const *const *"));
+static_assert(tokenize("char *").size() == 4);
+
+namespace {
+
+class Instrument : public testing::Test {
+protected:
+  void SetUp() override { instrument::reset(); }
+};
+
+} // namespace
+
+TEST_F(Instrument, CowDetach) {
+  COWString str{"Hello, world!"};
+  COWString copy = str;
+  copy.setChar(0, 'h');
+  copy.setChar(1, 'E');
+
+  auto snapshot = instrument::snapshot();
+  EXPECT_EQ(snapshot[Counter::eCowDetach], 1u);
+  EXPECT_EQ(snapshot[Counter::eCowDetachBytes], 13u);
+  EXPECT_EQ(snapshot[Timer::eCowDetach].calls, 1u);
+}
+
+TEST_F(Instrument, CowTokenizer) {
+  COWString str{"a b  c"};
+  COWTokenizer tokenizer{str, ' '};
+  while (!tokenizer.get().empty()) {
+  }
+
+  EXPECT_EQ(instrument::snapshot()[Counter::eCowTokenizerGet], 4u);
+}
+
+TEST_F(Instrument, Twine) {
+  using namespace std::literals;
+  auto str = StringTwine{"Hello, "sv, "world"sv, "!"sv}.str();
+
+  auto snapshot = instrument::snapshot();
+  EXPECT_EQ(snapshot[Counter::eTwineConcat], 3u);
+  EXPECT_EQ(snapshot[Counter::eTwineFlatten], 1u);
+  EXPECT_EQ(snapshot[Counter::eTwineFlattenBytes], str.size());
+  EXPECT_EQ(snapshot[Timer::eTwineFlatten].calls, 1u);
+}
+
+TEST_F(Instrument, TokenizeAndTestqual) {
+  EXPECT_TRUE(testqual(std::string_view{"char *"}, "char const *"));
+  EXPECT_FALSE(tryTokenize("char const const"));
+  EXPECT_FALSE(tryTestqual("char *", "char x"));
+
+  auto snapshot = instrument::snapshot();
+  EXPECT_EQ(snapshot[Counter::eTestqual], 2u);
+  EXPECT_EQ(snapshot[Counter::eTokenize], 5u);
+  EXPECT_EQ(snapshot[Counter::eTokenizeErrors], 2u);
+  EXPECT_EQ(snapshot[Timer::eTokenize].calls, 5u);
+  EXPECT_EQ(snapshot[Timer::eTestqual].calls, 2u);
+  EXPECT_GT(snapshot[Timer::eTestqual].cycles, 0u);
+}
+
+TEST_F(Instrument, Threads) {
+  constexpr int threads = 4;
+  constexpr int perThread = 1000;
+  {
+    std::jthread live{[] { (void)tokenize("char"); }};
+  }
+  std::vector<std::jthread> workers{};
+  for (int t = 0; t < threads; ++t)
+    workers.emplace_back([] {
+      for (int i = 0; i < perThread; ++i)
+        (void)tokenize("char *const *");
+    });
+  workers.clear();
+
+  // Finished threads are folded into the totals.
+  EXPECT_EQ(instrument::snapshot()[Counter::eTokenize],
+            1u + threads * perThread);
+}
+
+TEST_F(Instrument, Export) {
+  COWString str{"abc"};
+  COWString copy = str;
+  copy.setChar(0, 'x');
+  auto snapshot = instrument::snapshot();
+
+  auto prometheus = instrument::toPrometheus(snapshot);
+  EXPECT_NE(prometheus.find("# TYPE l1_cow_detach_total counter\n"
+                            "l1_cow_detach_total 1\n"),
+            std::string::npos);
+  EXPECT_NE(prometheus.find("l1_cow_detach_bytes_total 3\n"),
+            std::string::npos);
+  EXPECT_NE(prometheus.find("l1_timer_calls_total{timer=\"cow_detach\"} 1\n"),
+            std::string::npos);
+
+  auto json = instrument::toJson(snapshot);
+  EXPECT_EQ(json.front(), '{');
+  EXPECT_EQ(json.back(), '}');
+  EXPECT_NE(json.find("\"enabled\":true"), std::string::npos);
+  EXPECT_NE(json.find("\"cow_detach\":1,"), std::string::npos);
+  EXPECT_NE(json.find("\"cow_detach\":{\"calls\":1,\"cycles\":"),
+            std::string::npos);
+}
@@ -0,0 +1,53 @@
+#include <cstddef>
+#include <iterator>
+#include <string>
+
+#include <fmt/format.h>
+
+#include "instrument.hh"
+
+namespace l1::instrument {
+
+std::string toPrometheus(const Snapshot &snapshot) {
+  std::string res{};
+  auto out = std::back_inserter(res);
+
+  for (std::size_t i = 0; i < kCounters; ++i) {
+    auto metric = name(static_cast<Counter>(i));
+    fmt::format_to(out, "# TYPE l1_{}_total counter\n", metric);
+    fmt::format_to(out, "l1_{}_total {}\n", metric, snapshot.counters[i]);
+  }
+
+  fmt::format_to(out, "# TYPE l1_timer_calls_total counter\n");
+  for (std::size_t i = 0; i < kTimers; ++i)
+    fmt::format_to(out, "l1_timer_calls_total{{timer=\"{}\"}} {}\n",
+                   name(static_cast<Timer>(i)), snapshot.timers[i].calls);
+
+  fmt::format_to(out, "# TYPE l1_timer_cycles_total counter\n");
+  for (std::size_t i = 0; i < kTimers; ++i)
+    fmt::format_to(out, "l1_timer_cycles_total{{timer=\"{}\"}} {}\n",
+                   name(static_cast<Timer>(i)), snapshot.timers[i].cycles);
+
+  return res;
+}
+
+std::string toJson(const Snapshot &snapshot) {
+  std::string res{"{\"enabled\":"};
+  auto out = std::back_inserter(res);
+  fmt::format_to(out, "{},\"counters\":{{", kEnabled);
+
+  for (std::size_t i = 0; i < kCounters; ++i)
+    fmt::format_to(out, "{}\"{}\":{}", i ? "," : "",
+                   name(static_cast<Counter>(i)), snapshot.counters[i]);
+
+  res += "},\"timers\":{";
+  for (std::size_t i = 0; i < kTimers; ++i)
+    fmt::format_to(out, "{}\"{}\":{{\"calls\":{},\"cycles\":{}}}",
+                   i ? "," : "", name(static_cast<Timer>(i)),
+                   snapshot.timers[i].calls, snapshot.timers[i].cycles);
+
+  res += "}}";
+  return res;
+}
+
+} // namespace l1::instrument
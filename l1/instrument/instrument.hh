@@ -0,0 +1,277 @@
+#ifndef __L1_INSTRUMENT_INSTRUMENT_HH__
+#define __L1_INSTRUMENT_INSTRUMENT_HH__
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#ifdef CPP_MASTER_INSTRUMENT
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+#endif
+
+/* Hot path counters and timers of the l1 primitives. Built only with
+   CPP_MASTER_INSTRUMENT defined (the CPP_MASTER_INSTRUMENT CMake option),
+   otherwise count() and ScopedTimer are empty and compile away. Every
+   thread updates its own block without locking, snapshot() sums them. */
+namespace l1::instrument {
+
+#ifdef CPP_MASTER_INSTRUMENT
+inline constexpr bool kEnabled = true;
+#else
+inline constexpr bool kEnabled = false;
+#endif
+
+enum class Counter : std::uint8_t {
+  eCowDetach,
+  eCowDetachBytes,
+  eCowTokenizerGet,
+  eTwineConcat,
+  eTwineFlatten,
+  eTwineFlattenBytes,
+  eTokenize,
+  eTokenizeErrors,
+  eTestqual,
+};
+
+enum class Timer : std::uint8_t {
+  eCowDetach,
+  eTwineFlatten,
+  eTokenize,
+  eTestqual,
+};
+
+inline constexpr std::size_t kCounters =
+    std::to_underlying(Counter::eTestqual) + 1;
+inline constexpr std::size_t kTimers = std::to_underlying(Timer::eTestqual) + 1;
+
+constexpr std::string_view name(Counter counter) {
+  switch (counter) {
+  case Counter::eCowDetach:
+    return "cow_detach";
+  case Counter::eCowDetachBytes:
+    return "cow_detach_bytes";
+  case Counter::eCowTokenizerGet:
+    return "cow_tokenizer_get";
+  case Counter::eTwineConcat:
+    return "twine_concat";
+  case Counter::eTwineFlatten:
+    return "twine_flatten";
+  case Counter::eTwineFlattenBytes:
+    return "twine_flatten_bytes";
+  case Counter::eTokenize:
+    return "tokenize";
+  case Counter::eTokenizeErrors:
+    return "tokenize_errors";
+  case Counter::eTestqual:
+    return "testqual";
+  default:
+    return "unknown";
+  }
+}
+
+constexpr std::string_view name(Timer timer) {
+  switch (timer) {
+  case Timer::eCowDetach:
+    return "cow_detach";
+  case Timer::eTwineFlatten:
+    return "twine_flatten";
+  case Timer::eTokenize:
+    return "tokenize";
+  case Timer::eTestqual:
+    return "testqual";
+  default:
+    return "unknown";
+  }
+}
+
+struct TimerTotals final {
+  std::uint64_t calls = 0;
+  std::uint64_t cycles = 0;
+
+  bool operator==(const TimerTotals &) const = default;
+};
+
+/* Totals over all threads at one point in time. Cycles are TSC ticks on
+   x86 and steady_clock ticks elsewhere, timers nest and include the time
+   of the timers inside them. */
+struct Snapshot final {
+  std::array<std::uint64_t, kCounters> counters{};
+  std::array<TimerTotals, kTimers> timers{};
+
+  std::uint64_t operator[](Counter counter) const {
+    return counters[std::to_underlying(counter)];
+  }
+  const TimerTotals &operator[](Timer timer) const {
+    return timers[std::to_underlying(timer)];
+  }
+
+  bool operator==(const Snapshot &) const = default;
+};
+
+// Prometheus text exposition format, metric names prefixed with l1_.
+std::string toPrometheus(const Snapshot &snapshot);
+std::string toJson(const Snapshot &snapshot);
+
+#ifdef CPP_MASTER_INSTRUMENT
+
+namespace detail {
+
+using Cell = std::atomic<std::uint64_t>;
+
+// Only the owning thread writes, so no read-modify-write is needed.
+inline void add(Cell &cell, std::uint64_t n) {
+  cell.store(cell.load(std::memory_order_relaxed) + n,
+             std::memory_order_relaxed);
+}
+
+inline std::uint64_t cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return static_cast<std::uint64_t>(
+      std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+struct ThreadBlock;
+
+struct Registry final {
+  std::mutex mutex{};
+  std::vector<ThreadBlock *> live{};
+  Snapshot retired{};
+};
+
+inline Registry &registry() {
+  static Registry instance{};
+  return instance;
+}
+
+struct ThreadBlock final {
+  std::array<Cell, kCounters> counters{};
+  std::array<Cell, kTimers> calls{};
+  std::array<Cell, kTimers> cycles{};
+
+  ThreadBlock() {
+    auto &reg = registry();
+    std::lock_guard lock{reg.mutex};
+    reg.live.push_back(this);
+  }
+
+  ThreadBlock(const ThreadBlock &) = delete;
+  ThreadBlock &operator=(const ThreadBlock &) = delete;
+
+  // Counts of finished threads are kept in the registry.
+  ~ThreadBlock() {
+    auto &reg = registry();
+    std::lock_guard lock{reg.mutex};
+    addTo(reg.retired);
+    std::erase(reg.live, this);
+  }
+
+  void addTo(Snapshot &snapshot) const {
+    for (std::size_t i = 0; i < kCounters; ++i)
+      snapshot.counters[i] += counters[i].load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < kTimers; ++i) {
+      snapshot.timers[i].calls += calls[i].load(std::memory_order_relaxed);
+      snapshot.timers[i].cycles += cycles[i].load(std::memory_order_relaxed);
+    }
+  }
+
+  void clear() {
+    for (auto &cell : counters)
+      cell.store(0, std::memory_order_relaxed);
+    for (std::size_t i = 0; i < kTimers; ++i) {
+      calls[i].store(0, std::memory_order_relaxed);
+      cycles[i].store(0, std::memory_order_relaxed);
+    }
+  }
+};
+
+inline ThreadBlock &local() {
+  thread_local ThreadBlock block{};
+  return block;
+}
+
+} // namespace detail
+
+constexpr void count(Counter counter, std::uint64_t n = 1) {
+  if !consteval {
+    detail::add(detail::local().counters[std::to_underlying(counter)], n);
+  }
+}
+
+/* Adds the cycles between construction and destruction to the timer. Does
+   nothing during constant evaluation. */
+class ScopedTimer final {
+private:
+  Timer timer_;
+  std::uint64_t start_ = 0;
+
+public:
+  constexpr explicit ScopedTimer(Timer timer) : timer_(timer) {
+    if !consteval {
+      start_ = detail::cycles();
+    }
+  }
+
+  ScopedTimer(const ScopedTimer &) = delete;
+  ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+  constexpr ~ScopedTimer() {
+    if !consteval {
+      auto elapsed = detail::cycles() - start_;
+      auto &block = detail::local();
+      auto i = std::to_underlying(timer_);
+      detail::add(block.calls[i], 1);
+      detail::add(block.cycles[i], elapsed);
+    }
+  }
+};
+
+inline Snapshot snapshot() {
+  auto &reg = detail::registry();
+  std::lock_guard lock{reg.mutex};
+  auto res = reg.retired;
+  for (const auto *block : reg.live)
+    block->addTo(res);
+  return res;
+}
+
+// Zeroes everything; increments racing with it may survive.
+inline void reset() {
+  auto &reg = detail::registry();
+  std::lock_guard lock{reg.mutex};
+  reg.retired = {};
+  for (auto *block : reg.live)
+    block->clear();
+}
+
+#else
+
+constexpr void count(Counter, std::uint64_t = 1) {}
+
+class ScopedTimer final {
+public:
+  constexpr explicit ScopedTimer(Timer) {}
+};
+
+inline Snapshot snapshot() { return {}; }
+inline void reset() {}
+
+#endif
+
+} // namespace l1::instrument
+
+#endif // __L1_INSTRUMENT_INSTRUMENT_HH__
@@ -7,6 +7,8 @@
 #include <string_view>
 #include <variant>
 
+#include "l1/instrument/instrument.hh"
+
 namespace l1 {
 
 struct StringTwineNode final {
@@ -51,6 +53,7 @@ public:
   void concat() {}
 
   void concatOne(std::string_view sv) {
+    instrument::count(instrument::Counter::eTwineConcat);
     if (std::holds_alternative<std::monostate>(node_->lhs_)) {
       node_->lhs_ = std::make_shared<std::string_view>(sv.data(), sv.size());
       return;
@@ -70,9 +73,13 @@ public:
   void print(std::ostream &os) const && { node_->print(os); }
 
   std::string str() const && {
+    instrument::ScopedTimer timer{instrument::Timer::eTwineFlatten};
     std::stringstream ss{};
     node_->print(ss);
-    return ss.str();
+    auto res = ss.str();
+    instrument::count(instrument::Counter::eTwineFlatten);
+    instrument::count(instrument::Counter::eTwineFlattenBytes, res.size());
+    return res;
   }
 };
 
@@ -0,0 +1,42 @@
+/* Compile time benchmark for sort(): the interesting number is how long
+   this file takes to build, see the l6-tuple-sort-ctbench target. */
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+#include "tuple-sort.hh"
+
+#ifndef CTBENCH_ARITY
+#define CTBENCH_ARITY 16
+#endif
+
+#ifndef CTBENCH_HANA
+#define CTBENCH_HANA 0
+#endif
+
+namespace {
+
+// Distinct element types with mixed sizes and alignments.
+template <std::size_t I> struct alignas(1 << I % 4) Blob {
+  char data[(I % 3 + 1) << I % 4];
+};
+
+template <std::size_t... I> auto makeTuple(std::index_sequence<I...>) {
+  return std::tuple<Blob<I>...>{};
+}
+
+using Tuple = decltype(makeTuple(std::make_index_sequence<CTBENCH_ARITY>{}));
+
+// Only the return type is needed, so no code is generated for the sort.
+#if CTBENCH_HANA
+using Sorted = decltype(l6::hanaSort(std::declval<Tuple>()));
+#else
+using Sorted = decltype(l6::sort(std::declval<Tuple>()));
+#endif
+
+static_assert(std::tuple_size_v<Sorted> == CTBENCH_ARITY);
+
+} // namespace
+
+std::size_t ctbench() { return sizeof(Sorted); }
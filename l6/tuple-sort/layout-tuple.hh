@@ -0,0 +1,180 @@
+#ifndef __L6_TUPLE_SORT_LAYOUT_TUPLE_HH__
+#define __L6_TUPLE_SORT_LAYOUT_TUPLE_HH__
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "permutation.hh"
+
+namespace l6 {
+
+namespace detail {
+
+struct LayoutKey final {
+  std::size_t align;
+  std::size_t size;
+};
+
+// Stricter alignment first, then bigger size: no padding between members.
+constexpr bool layoutLess(const LayoutKey &lhs, const LayoutKey &rhs) {
+  if (lhs.align != rhs.align)
+    return lhs.align > rhs.align;
+  return lhs.size > rhs.size;
+}
+
+// sizeof a plain struct with these members in declaration order.
+template <typename... Ts> consteval std::size_t naiveSize() {
+  std::size_t offset = 0;
+  std::size_t maxAlign = 1;
+  auto place = [&](std::size_t align, std::size_t size) {
+    offset = (offset + align - 1) / align * align + size;
+    maxAlign = std::max(maxAlign, align);
+  };
+  (place(alignof(Ts), sizeof(Ts)), ...);
+  return (offset + maxAlign - 1) / maxAlign * maxAlign;
+}
+
+template <std::size_t K, typename T> struct LayoutLeaf {
+  [[no_unique_address]] T value{};
+
+  constexpr LayoutLeaf() = default;
+  template <typename Arg>
+  constexpr LayoutLeaf(std::in_place_t, Arg &&arg)
+      : value(std::forward<Arg>(arg)) {}
+};
+
+/* Bases are laid out in declaration order, so slot K is the K-th member
+   in memory. */
+template <typename Seq, typename... Ts> struct LayoutStorage;
+
+template <std::size_t... K, typename... Ts>
+struct LayoutStorage<std::index_sequence<K...>, Ts...> : LayoutLeaf<K, Ts>... {
+  constexpr LayoutStorage() = default;
+
+  // Slot K is built from std::get<Src[K]>(args).
+  template <std::size_t... Src, typename Args>
+  constexpr LayoutStorage(std::index_sequence<Src...>, Args &&args)
+      : LayoutLeaf<K, Ts>(std::in_place, std::get<Src>(std::move(args)))... {}
+};
+
+} // namespace detail
+
+struct LayoutReport final {
+  std::size_t naiveSize;
+  std::size_t optimizedSize;
+
+  constexpr std::size_t saved() const { return naiveSize - optimizedSize; }
+};
+
+/* Tuple which stores its members in the order giving the smallest sizeof,
+   while get<I> keeps using the original indices. kOrder[k] is the original
+   index of the member stored k-th, kSlot[i] is where member i is stored. */
+template <typename... Ts> class LayoutTuple final {
+public:
+  static constexpr std::size_t kSize = sizeof...(Ts);
+  static constexpr auto kOrder = stableOrder(
+      std::array<detail::LayoutKey, kSize>{
+          detail::LayoutKey{alignof(Ts), sizeof(Ts)}...},
+      detail::layoutLess);
+  static constexpr auto kSlot = inverse(kOrder);
+
+  template <std::size_t I>
+  using Element = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+private:
+  template <std::size_t... K>
+  static auto storageOf(std::index_sequence<K...>)
+      -> detail::LayoutStorage<std::index_sequence<K...>,
+                               Element<kOrder[K]>...>;
+
+  template <std::size_t... K>
+  static constexpr auto sourceOf(std::index_sequence<K...>) {
+    return std::index_sequence<kOrder[K]...>{};
+  }
+
+  using Storage = decltype(storageOf(std::make_index_sequence<kSize>{}));
+
+  Storage storage_{};
+
+  template <std::size_t I>
+  using Leaf = detail::LayoutLeaf<kSlot[I], Element<I>>;
+
+public:
+  static constexpr LayoutReport kReport{detail::naiveSize<Ts...>(),
+                                        sizeof(Storage)};
+  static_assert(kReport.optimizedSize <= kReport.naiveSize);
+
+  constexpr LayoutTuple() = default;
+
+  template <typename... Us>
+    requires(sizeof...(Us) == kSize && kSize != 0 &&
+             !(kSize == 1 &&
+               (std::is_same_v<std::remove_cvref_t<Us>, LayoutTuple> && ...)) &&
+             (std::is_constructible_v<Ts, Us &&> && ...))
+  constexpr explicit(!(std::is_convertible_v<Us &&, Ts> && ...))
+      LayoutTuple(Us &&...args)
+      : storage_(sourceOf(std::make_index_sequence<kSize>{}),
+                 std::forward_as_tuple(std::forward<Us>(args)...)) {}
+
+  template <std::size_t I> constexpr Element<I> &get() & {
+    return static_cast<Leaf<I> &>(storage_).value;
+  }
+  template <std::size_t I> constexpr const Element<I> &get() const & {
+    return static_cast<const Leaf<I> &>(storage_).value;
+  }
+  template <std::size_t I> constexpr Element<I> &&get() && {
+    return std::forward<Element<I>>(static_cast<Leaf<I> &>(storage_).value);
+  }
+
+  // Member offsets by original index, mostly for inspection.
+  template <std::size_t I> std::size_t offsetOf() const {
+    return static_cast<std::size_t>(
+        reinterpret_cast<const char *>(&get<I>()) -
+        reinterpret_cast<const char *>(this));
+  }
+
+  std::tuple<Ts...> toTuple() const & {
+    return [this]<std::size_t... I>(std::index_sequence<I...>) {
+      return std::tuple<Ts...>{get<I>()...};
+    }(std::make_index_sequence<kSize>{});
+  }
+
+  friend constexpr bool operator==(const LayoutTuple &lhs,
+                                   const LayoutTuple &rhs) {
+    return [&]<std::size_t... I>(std::index_sequence<I...>) {
+      return ((lhs.get<I>() == rhs.get<I>()) && ...);
+    }(std::make_index_sequence<kSize>{});
+  }
+};
+
+template <typename... Ts> LayoutTuple(Ts...) -> LayoutTuple<Ts...>;
+
+template <std::size_t I, typename... Ts>
+constexpr decltype(auto) get(LayoutTuple<Ts...> &t) {
+  return t.template get<I>();
+}
+template <std::size_t I, typename... Ts>
+constexpr decltype(auto) get(const LayoutTuple<Ts...> &t) {
+  return t.template get<I>();
+}
+template <std::size_t I, typename... Ts>
+constexpr decltype(auto) get(LayoutTuple<Ts...> &&t) {
+  return std::move(t).template get<I>();
+}
+
+} // namespace l6
+
+template <typename... Ts>
+struct std::tuple_size<l6::LayoutTuple<Ts...>>
+    : std::integral_constant<std::size_t, sizeof...(Ts)> {};
+
+template <std::size_t I, typename... Ts>
+struct std::tuple_element<I, l6::LayoutTuple<Ts...>> {
+  using type = typename l6::LayoutTuple<Ts...>::template Element<I>;
+};
+
+#endif // __L6_TUPLE_SORT_LAYOUT_TUPLE_HH__
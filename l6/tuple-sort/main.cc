@@ -1,38 +1,16 @@
 #include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 
 #include <gtest/gtest.h>
 
-#include <boost/hana.hpp>
-#include <boost/hana/fwd/sort.hpp>
-#include <boost/hana/fwd/transform.hpp>
-#include <boost/hana/fwd/tuple.hpp>
-#include <boost/hana/fwd/type.hpp>
-#include <boost/hana/fwd/unpack.hpp>
+#include "layout-tuple.hh"
+#include "tuple-sort.hh"
 
-namespace hana = boost::hana;
-
-template <typename T>
-concept TupleLike = requires {
-  typename std::tuple_size<T>::type;
-  typename std::tuple_element<0, T>::type;
-  std::get<0>(std::declval<T>());
-};
-
-template <TupleLike Tuple, std::size_t... I>
-constexpr auto toHana(const Tuple &tuple, std::index_sequence<I...>) {
-  return hana::make_tuple(std::make_pair(
-      hana::type_c<std::tuple_element<I, Tuple>>, std::get<I>(tuple))...);
-}
-
-template <TupleLike Tuple> constexpr auto sort(Tuple t) {
-  auto ht = toHana(t, std::make_index_sequence<std::tuple_size_v<Tuple>>{});
-  auto sorted = hana::sort(
-      ht, [](auto l, auto r) { return hana::sizeof_(l) < hana::sizeof_(r); });
-
-  return hana::unpack(sorted, [](auto... e) { return Tuple{e.second...}; });
-}
+using l6::sort;
 
 TEST(SortTuple, StandardTuple) {
   std::tuple<int, char, double> original{1, 'c', 2.0};
@@ -73,3 +51,161 @@ TEST(SortTuple, Array) {
 
   ASSERT_EQ(sorted, expected);
 }
+
+static_assert(l6::kSortOrder<std::tuple<double, char[3], short, int>> ==
+              std::array<std::size_t, 4>{2, 1, 3, 0});
+static_assert(
+    std::is_same_v<decltype(sort(std::tuple<int, char, short>{})),
+                   std::tuple<char, short, int>>);
+static_assert(std::get<0>(sort(std::tuple<int, char>{1, 'c'})) == 'c');
+
+TEST(SortTuple, SameAsHana) {
+  std::tuple<double, int, char, float, short> original{1.0, 2, 'c', 3.0f,
+                                                       short{4}};
+  EXPECT_EQ(sort(original), l6::hanaSort(original));
+
+  std::pair<int, char> pair{1, 'c'};
+  EXPECT_EQ(sort(pair), l6::hanaSort(pair));
+}
+
+namespace {
+
+struct Counts final {
+  int copies = 0;
+  int moves = 0;
+};
+
+// Reports its copies and moves to a Counts.
+class Tracked final {
+private:
+  Counts *counts_;
+
+public:
+  explicit Tracked(Counts &counts) : counts_(&counts) {}
+  Tracked(const Tracked &other) : counts_(other.counts_) {
+    ++counts_->copies;
+  }
+  Tracked(Tracked &&other) noexcept : counts_(other.counts_) {
+    ++counts_->moves;
+  }
+  Tracked &operator=(const Tracked &) = delete;
+  Tracked &operator=(Tracked &&) = delete;
+  ~Tracked() = default;
+};
+
+} // namespace
+
+TEST(SortTuple, LvalueCopiesOnce) {
+  Counts counts{};
+  std::tuple<Tracked, char, int> original{Tracked{counts}, 'c', 1};
+  counts = {};
+
+  auto sorted = sort(original);
+  static_assert(
+      std::is_same_v<decltype(sorted), std::tuple<char, int, Tracked>>);
+  EXPECT_EQ(counts.copies, 1);
+  EXPECT_EQ(counts.moves, 0);
+  EXPECT_EQ(std::get<0>(sorted), 'c');
+}
+
+TEST(SortTuple, RvalueOnlyMoves) {
+  Counts counts{};
+  std::tuple<Tracked, char, int> original{Tracked{counts}, 'c', 1};
+  counts = {};
+
+  auto sorted = sort(std::move(original));
+  EXPECT_EQ(counts.copies, 0);
+  EXPECT_EQ(counts.moves, 1);
+  EXPECT_EQ(std::get<1>(sorted), 1);
+}
+
+TEST(SortTuple, MoveOnly) {
+  std::tuple<std::unique_ptr<int>, char> original{std::make_unique<int>(5),
+                                                  'c'};
+  auto sorted = sort(std::move(original));
+
+  ASSERT_NE(std::get<1>(sorted), nullptr);
+  EXPECT_EQ(*std::get<1>(sorted), 5);
+  EXPECT_EQ(std::get<0>(sorted), 'c');
+  EXPECT_EQ(std::get<0>(original), nullptr);
+
+  std::array<std::unique_ptr<int>, 2> ptrs{std::make_unique<int>(1),
+                                           std::make_unique<int>(2)};
+  auto sortedPtrs = sort(std::move(ptrs));
+  EXPECT_EQ(*sortedPtrs[0], 1);
+  EXPECT_EQ(*sortedPtrs[1], 2);
+}
+
+TEST(SortTuple, References) {
+  double d = 1.0;
+  char c = 'c';
+  int i = 1;
+
+  auto sorted = sort(std::tie(d, c, i));
+  static_assert(
+      std::is_same_v<decltype(sorted), std::tuple<char &, int &, double &>>);
+  std::get<0>(sorted) = 'z';
+  std::get<2>(sorted) = 2.0;
+  EXPECT_EQ(c, 'z');
+  EXPECT_EQ(d, 2.0);
+
+  std::tuple<double &, char &> refs{d, c};
+  auto sortedRefs = sort(refs);
+  EXPECT_EQ(&std::get<0>(sortedRefs), &c);
+  EXPECT_EQ(&std::get<1>(sortedRefs), &d);
+}
+
+using Record = l6::LayoutTuple<char, double, int, short, char>;
+
+static_assert(Record::kOrder == std::array<std::size_t, 5>{1, 2, 3, 0, 4});
+static_assert(Record::kReport.naiveSize == 24);
+static_assert(sizeof(Record) == Record::kReport.optimizedSize);
+static_assert(sizeof(Record) == 16);
+static_assert(Record::kReport.saved() == 8);
+static_assert(std::is_same_v<std::tuple_element_t<1, Record>, double>);
+
+TEST(LayoutTuple, OriginalIndices) {
+  Record r{'a', 2.5, 3, short{4}, 'e'};
+
+  EXPECT_EQ(l6::get<0>(r), 'a');
+  EXPECT_EQ(l6::get<1>(r), 2.5);
+  EXPECT_EQ(l6::get<2>(r), 3);
+  EXPECT_EQ(l6::get<3>(r), 4);
+  EXPECT_EQ(l6::get<4>(r), 'e');
+
+  l6::get<2>(r) = 7;
+  auto [c0, d, i, s, c1] = r;
+  EXPECT_EQ(i, 7);
+  EXPECT_EQ(r.toTuple(), std::make_tuple('a', 2.5, 7, short{4}, 'e'));
+}
+
+TEST(LayoutTuple, StorageOrder) {
+  Record r{};
+
+  // double, int, short, then both chars in their original order.
+  EXPECT_EQ(r.offsetOf<1>(), 0u);
+  EXPECT_EQ(r.offsetOf<2>(), 8u);
+  EXPECT_EQ(r.offsetOf<3>(), 12u);
+  EXPECT_EQ(r.offsetOf<0>(), 14u);
+  EXPECT_EQ(r.offsetOf<4>(), 15u);
+}
+
+TEST(LayoutTuple, AlreadyOptimal) {
+  using Packed = l6::LayoutTuple<std::uint64_t, std::uint32_t, std::uint8_t>;
+  static_assert(Packed::kReport.saved() == 0);
+  static_assert(Packed::kOrder == std::array<std::size_t, 3>{0, 1, 2});
+
+  Packed p{1u, 2u, std::uint8_t{3}};
+  EXPECT_EQ(p, (Packed{1u, 2u, std::uint8_t{3}}));
+}
+
+TEST(LayoutTuple, MoveOnly) {
+  using Owner = l6::LayoutTuple<char, std::unique_ptr<int>, bool>;
+  Owner o{'x', std::make_unique<int>(5), true};
+
+  auto p = l6::get<1>(std::move(o));
+  ASSERT_NE(p, nullptr);
+  EXPECT_EQ(*p, 5);
+  EXPECT_EQ(l6::get<1>(o), nullptr);
+  EXPECT_EQ(sizeof(Owner), 16u);
+}
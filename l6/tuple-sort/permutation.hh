@@ -0,0 +1,40 @@
+#ifndef __L6_TUPLE_SORT_PERMUTATION_HH__
+#define __L6_TUPLE_SORT_PERMUTATION_HH__
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+namespace l6 {
+
+/* Indices 0..N-1 stably sorted by their keys: order[k] is the index of the
+   k-th smallest key, equal keys keep their relative order. Insertion sort
+   is plenty for tuple arities and cheap to evaluate at compile time. */
+template <typename Key, std::size_t N, typename Less = std::less<>>
+consteval std::array<std::size_t, N> stableOrder(const std::array<Key, N> &keys,
+                                                 Less less = {}) {
+  std::array<std::size_t, N> order{};
+  for (std::size_t i = 0; i < N; ++i)
+    order[i] = i;
+
+  for (std::size_t i = 1; i < N; ++i)
+    for (auto j = i; j > 0 && less(keys[order[j]], keys[order[j - 1]]); --j)
+      std::swap(order[j], order[j - 1]);
+
+  return order;
+}
+
+// inverse(order)[order[k]] == k.
+template <std::size_t N>
+consteval std::array<std::size_t, N>
+inverse(const std::array<std::size_t, N> &order) {
+  std::array<std::size_t, N> res{};
+  for (std::size_t k = 0; k < N; ++k)
+    res[order[k]] = k;
+  return res;
+}
+
+} // namespace l6
+
+#endif // __L6_TUPLE_SORT_PERMUTATION_HH__
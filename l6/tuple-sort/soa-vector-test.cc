@@ -0,0 +1,233 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "soa-vector.hh"
+
+namespace {
+
+using Row = std::tuple<std::uint64_t, double, char>;
+using Soa = l6::SoaVector<Row>;
+
+static_assert(std::random_access_iterator<Soa::iterator>);
+static_assert(std::random_access_iterator<Soa::const_iterator>);
+static_assert(std::ranges::random_access_range<Soa>);
+static_assert(
+    std::is_same_v<std::tuple_element_t<1, Soa::reference>, double &>);
+
+std::vector<Row> makeRows(std::size_t n) {
+  std::vector<Row> rows{};
+  for (std::size_t i = 0; i < n; ++i)
+    rows.emplace_back(i, static_cast<double>(i) / 2,
+                      static_cast<char>('a' + i % 26));
+  return rows;
+}
+
+template <typename T> bool aligned(const T *p, std::size_t align) {
+  return reinterpret_cast<std::uintptr_t>(p) % align == 0;
+}
+
+} // namespace
+
+TEST(SoaVector, PushAndAccess) {
+  Soa soa{};
+  EXPECT_TRUE(soa.empty());
+
+  soa.push_back({1, 1.5, 'a'});
+  Row row{2, 2.5, 'b'};
+  soa.push_back(row);
+  auto ref = soa.emplace_back(3u, 3.5, 'c');
+
+  ASSERT_EQ(soa.size(), 3u);
+  EXPECT_EQ(ref.get<0>(), 3u);
+  EXPECT_EQ(static_cast<Row>(soa[0]), (Row{1, 1.5, 'a'}));
+  EXPECT_EQ(soa[1], row);
+
+  auto [id, price, tag] = soa[2];
+  price = 4.0;
+  EXPECT_EQ(id, 3u);
+  EXPECT_EQ(tag, 'c');
+  EXPECT_EQ(l6::get<1>(soa[2]), 4.0);
+
+  soa[0] = Row{9, 9.5, 'z'};
+  EXPECT_EQ(soa[0], (Row{9, 9.5, 'z'}));
+
+  soa.pop_back();
+  EXPECT_EQ(soa.size(), 2u);
+}
+
+TEST(SoaVector, Columns) {
+  auto rows = makeRows(1000);
+  Soa soa{rows};
+
+  auto ids = soa.column<0>();
+  auto prices = soa.column<1>();
+  ASSERT_EQ(ids.size(), rows.size());
+  EXPECT_TRUE(aligned(ids.data(), Soa::kColumnAlign));
+  EXPECT_TRUE(aligned(prices.data(), Soa::kColumnAlign));
+  EXPECT_TRUE(aligned(soa.column<2>().data(), Soa::kColumnAlign));
+
+  EXPECT_EQ(std::accumulate(ids.begin(), ids.end(), std::uint64_t{0}),
+            999u * 1000u / 2);
+
+  for (auto &price : prices)
+    price *= 2;
+  EXPECT_EQ(std::get<1>(static_cast<Row>(soa[10])), 10.0);
+}
+
+TEST(SoaVector, VectorRoundTrip) {
+  auto rows = makeRows(100);
+  Soa soa{rows};
+
+  EXPECT_EQ(soa.toVector(), rows);
+  EXPECT_EQ(Soa{soa.toVector()}, soa);
+  EXPECT_EQ(Soa{}.toVector(), std::vector<Row>{});
+}
+
+TEST(SoaVector, Iteration) {
+  Soa soa{makeRows(50)};
+
+  std::size_t i = 0;
+  for (auto row : soa)
+    EXPECT_EQ(row.get<0>(), i++);
+  EXPECT_EQ(i, 50u);
+
+  const auto &csoa = soa;
+  EXPECT_EQ(std::ranges::count_if(
+                csoa, [](auto row) { return row.template get<2>() == 'a'; }),
+            2);
+
+  std::ranges::sort(soa, [](const Row &lhs, const Row &rhs) {
+    return std::get<2>(lhs) > std::get<2>(rhs);
+  });
+  EXPECT_TRUE(std::ranges::is_sorted(soa.column<2>(), std::greater<>{}));
+  for (auto row : soa)
+    EXPECT_EQ(static_cast<char>('a' + row.get<0>() % 26), row.get<2>());
+
+  Soa::const_iterator it = soa.begin();
+  EXPECT_EQ(soa.end() - it, 50);
+}
+
+TEST(SoaVector, CopyAndMove) {
+  Soa soa{makeRows(10)};
+
+  Soa copy{soa};
+  EXPECT_EQ(copy, soa);
+  copy[0] = Row{42, 0.0, 'x'};
+  EXPECT_NE(copy, soa);
+
+  Soa moved{std::move(copy)};
+  EXPECT_EQ(moved.size(), 10u);
+  EXPECT_EQ(moved[0].get<0>(), 42u);
+
+  copy = moved;
+  EXPECT_EQ(copy, moved);
+  soa = std::move(moved);
+  EXPECT_EQ(soa, copy);
+}
+
+TEST(SoaVector, NonTrivialColumns) {
+  using Named = std::pair<std::string, std::unique_ptr<int>>;
+  l6::SoaVector<Named> soa{};
+
+  for (int i = 0; i < 100; ++i)
+    soa.emplace_back(std::to_string(i), std::make_unique<int>(i));
+  soa.push_back(Named{"last", nullptr});
+
+  ASSERT_EQ(soa.size(), 101u);
+  EXPECT_GE(soa.capacity(), 101u);
+  EXPECT_EQ(soa.column<0>()[57], "57");
+  EXPECT_EQ(*soa.column<1>()[57], 57);
+  EXPECT_EQ(soa.column<1>()[100], nullptr);
+
+  soa.clear();
+  EXPECT_TRUE(soa.empty());
+}
+
+// Like std::vector, the arguments may refer into the container itself.
+TEST(SoaVector, EmplaceFromOwnElements) {
+  using Named = std::tuple<std::string, int>;
+  l6::SoaVector<Named> soa{};
+  soa.emplace_back(std::string(32, 'x'), 1);
+
+  int reallocations = 0;
+  for (int i = 0; i < 10; ++i) {
+    auto capacity = soa.capacity();
+    soa.emplace_back(soa.column<0>()[0], soa.column<1>()[0]);
+    soa.push_back(soa[0]);
+    reallocations += soa.capacity() != capacity;
+  }
+
+  EXPECT_GE(reallocations, 4);
+  ASSERT_EQ(soa.size(), 21u);
+  for (std::size_t i = 0; i < soa.size(); ++i) {
+    EXPECT_EQ(soa.column<0>()[i], std::string(32, 'x'));
+    EXPECT_EQ(soa.column<1>()[i], 1);
+  }
+}
+
+TEST(SoaVector, StrongGuarantee) {
+  struct Fragile {
+    int value;
+    explicit Fragile(int v) : value(v) {
+      if (v < 0)
+        throw std::runtime_error{"negative"};
+    }
+  };
+  using Pair = std::pair<std::string, Fragile>;
+  l6::SoaVector<Pair> soa{};
+  soa.emplace_back("one", 1);
+
+  EXPECT_THROW(soa.emplace_back("two", -1), std::runtime_error);
+  ASSERT_EQ(soa.size(), 1u);
+  EXPECT_EQ(soa.column<0>()[0], "one");
+  EXPECT_EQ(soa.column<1>()[0].value, 1);
+}
+
+/* A column which can only be moved, by a move which throws: the rows of
+   the other columns survive and nothing leaks or is destroyed twice. */
+TEST(SoaVector, ThrowingMove) {
+  struct MoveOnly {
+    std::unique_ptr<int> value;
+    explicit MoveOnly(int v) : value(std::make_unique<int>(v)) {}
+    MoveOnly(MoveOnly &&other) : value(std::move(other.value)) {
+      if (*value == 2)
+        throw std::runtime_error{"move"};
+    }
+  };
+  using Pair = std::pair<std::string, MoveOnly>;
+  l6::SoaVector<Pair> soa{};
+  soa.reserve(3);
+  for (int i = 1; i <= 3; ++i)
+    soa.emplace_back(std::string(32, static_cast<char>('0' + i)), i);
+
+  EXPECT_THROW(soa.emplace_back("four", 4), std::runtime_error);
+  ASSERT_EQ(soa.size(), 3u);
+  EXPECT_EQ(soa.capacity(), 3u);
+  EXPECT_EQ(soa.column<0>()[2], std::string(32, '3'));
+  EXPECT_EQ(*soa.column<1>()[2].value, 3);
+}
+
+TEST(SoaVector, Array) {
+  using Vec3 = std::array<float, 3>;
+  l6::SoaVector<Vec3> soa{};
+  soa.push_back({1, 2, 3});
+  soa.push_back({4, 5, 6});
+
+  auto ys = soa.column<1>();
+  EXPECT_EQ(ys[0] + ys[1], 7.0f);
+  EXPECT_EQ(static_cast<Vec3>(soa[1]), (Vec3{4, 5, 6}));
+}
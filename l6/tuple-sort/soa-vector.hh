@@ -0,0 +1,496 @@
+#ifndef __L6_TUPLE_SORT_SOA_VECTOR_HH__
+#define __L6_TUPLE_SORT_SOA_VECTOR_HH__
+
+#include <algorithm>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "tuple-like.hh"
+
+namespace l6 {
+
+template <TupleLike Tuple> class SoaVector;
+
+/* Proxy for one row of a SoaVector: get<I>() is a reference into column I.
+   Converts to a Tuple by copying the row, assigning a Tuple or another
+   reference writes through. */
+template <TupleLike Tuple, bool Const> class SoaReference final {
+private:
+  using Owner = std::conditional_t<Const, const SoaVector<Tuple>,
+                                   SoaVector<Tuple>>;
+
+  Owner *owner_;
+  std::size_t index_;
+
+  template <TupleLike, bool> friend class SoaReference;
+
+  template <typename Row> void assign(Row &&row) const {
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+      ((get<I>() = std::get<I>(std::forward<Row>(row))), ...);
+    }(std::make_index_sequence<std::tuple_size_v<Tuple>>{});
+  }
+
+public:
+  constexpr SoaReference(Owner &owner, std::size_t index)
+      : owner_(&owner), index_(index) {}
+
+  constexpr SoaReference(const SoaReference &) = default;
+
+  template <bool OtherConst>
+    requires(Const && !OtherConst)
+  constexpr SoaReference(const SoaReference<Tuple, OtherConst> &other)
+      : owner_(other.owner_), index_(other.index_) {}
+
+  const SoaReference &operator=(const Tuple &row) const
+    requires(!Const)
+  {
+    assign(row);
+    return *this;
+  }
+  const SoaReference &operator=(Tuple &&row) const
+    requires(!Const)
+  {
+    assign(std::move(row));
+    return *this;
+  }
+  const SoaReference &operator=(const SoaReference &other) const
+    requires(!Const)
+  {
+    assign(static_cast<Tuple>(other));
+    return *this;
+  }
+
+  template <std::size_t I> constexpr auto &get() const {
+    return owner_->template column<I>()[index_];
+  }
+
+  operator Tuple() const {
+    return [this]<std::size_t... I>(std::index_sequence<I...>) {
+      return Tuple{get<I>()...};
+    }(std::make_index_sequence<std::tuple_size_v<Tuple>>{});
+  }
+
+  friend void swap(const SoaReference &lhs, const SoaReference &rhs)
+    requires(!Const)
+  {
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+      using std::swap;
+      (swap(lhs.template get<I>(), rhs.template get<I>()), ...);
+    }(std::make_index_sequence<std::tuple_size_v<Tuple>>{});
+  }
+
+  friend bool operator==(const SoaReference &lhs, const Tuple &rhs) {
+    return static_cast<Tuple>(lhs) == rhs;
+  }
+};
+
+template <std::size_t I, TupleLike Tuple, bool Const>
+constexpr auto &get(const SoaReference<Tuple, Const> &ref) {
+  return ref.template get<I>();
+}
+
+/* Random access iterator over SoaReference proxies. */
+template <TupleLike Tuple, bool Const> class SoaIterator final {
+private:
+  using Owner = std::conditional_t<Const, const SoaVector<Tuple>,
+                                   SoaVector<Tuple>>;
+
+  Owner *owner_ = nullptr;
+  std::ptrdiff_t index_ = 0;
+
+  template <TupleLike, bool> friend class SoaIterator;
+
+public:
+  using iterator_concept = std::random_access_iterator_tag;
+  using iterator_category = std::input_iterator_tag;
+  using value_type = Tuple;
+  using difference_type = std::ptrdiff_t;
+  using reference = SoaReference<Tuple, Const>;
+
+  SoaIterator() = default;
+  SoaIterator(Owner &owner, std::ptrdiff_t index)
+      : owner_(&owner), index_(index) {}
+
+  template <bool OtherConst>
+    requires(Const && !OtherConst)
+  SoaIterator(const SoaIterator<Tuple, OtherConst> &other)
+      : owner_(other.owner_), index_(other.index_) {}
+
+  reference operator*() const {
+    return {*owner_, static_cast<std::size_t>(index_)};
+  }
+  reference operator[](difference_type n) const { return *(*this + n); }
+
+  SoaIterator &operator++() {
+    ++index_;
+    return *this;
+  }
+  SoaIterator operator++(int) {
+    auto copy = *this;
+    ++index_;
+    return copy;
+  }
+  SoaIterator &operator--() {
+    --index_;
+    return *this;
+  }
+  SoaIterator operator--(int) {
+    auto copy = *this;
+    --index_;
+    return copy;
+  }
+
+  SoaIterator &operator+=(difference_type n) {
+    index_ += n;
+    return *this;
+  }
+  SoaIterator &operator-=(difference_type n) {
+    index_ -= n;
+    return *this;
+  }
+
+  friend SoaIterator operator+(SoaIterator it, difference_type n) {
+    return it += n;
+  }
+  friend SoaIterator operator+(difference_type n, SoaIterator it) {
+    return it += n;
+  }
+  friend SoaIterator operator-(SoaIterator it, difference_type n) {
+    return it -= n;
+  }
+  friend difference_type operator-(const SoaIterator &lhs,
+                                   const SoaIterator &rhs) {
+    return lhs.index_ - rhs.index_;
+  }
+
+  friend bool operator==(const SoaIterator &lhs, const SoaIterator &rhs) {
+    return lhs.index_ == rhs.index_;
+  }
+  friend std::strong_ordering operator<=>(const SoaIterator &lhs,
+                                          const SoaIterator &rhs) {
+    return lhs.index_ <=> rhs.index_;
+  }
+};
+
+/* Structure-of-arrays container of Tuple rows: element I of every row lives
+   in column I, a separate contiguous array aligned to at least
+   kColumnAlign bytes. A loop over one field only walks that field's array,
+   and column<I>() gives it as a span for vectorized loops. Rows are
+   accessed through SoaReference proxies. */
+template <TupleLike Tuple> class SoaVector final {
+public:
+  static constexpr std::size_t kColumns = std::tuple_size_v<Tuple>;
+  static constexpr std::size_t kColumnAlign = 64;
+
+  template <std::size_t I> using Element = std::tuple_element_t<I, Tuple>;
+
+  using value_type = Tuple;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = SoaReference<Tuple, false>;
+  using const_reference = SoaReference<Tuple, true>;
+  using iterator = SoaIterator<Tuple, false>;
+  using const_iterator = SoaIterator<Tuple, true>;
+
+private:
+  static_assert([]<std::size_t... I>(std::index_sequence<I...>) {
+    return (std::is_object_v<Element<I>> && ...) &&
+           !(std::is_const_v<Element<I>> || ...);
+  }(std::make_index_sequence<kColumns>{}));
+
+  template <std::size_t... I>
+  static auto columnsOf(std::index_sequence<I...>)
+      -> std::tuple<Element<I> *...>;
+
+  using Columns = decltype(columnsOf(std::make_index_sequence<kColumns>{}));
+
+  Columns columns_{};
+  std::size_t size_ = 0;
+  std::size_t capacity_ = 0;
+
+  template <std::size_t I>
+  static constexpr std::align_val_t kAlign{
+      std::max(kColumnAlign, alignof(Element<I>))};
+
+  /* Columns which are copied on reallocation, because their move may throw
+     and a copy leaves the old buffer intact. */
+  template <std::size_t I>
+  static constexpr bool kCopyOnGrow =
+      !std::is_nothrow_move_constructible_v<Element<I>> &&
+      std::is_copy_constructible_v<Element<I>>;
+
+  // Columns which can only get across by a move which may throw.
+  template <std::size_t I>
+  static constexpr bool kThrowingMove =
+      !std::is_nothrow_move_constructible_v<Element<I>> && !kCopyOnGrow<I>;
+
+  template <typename F> static void forEachColumn(F &&f) {
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+      (f(std::integral_constant<std::size_t, I>{}), ...);
+    }(std::make_index_sequence<kColumns>{});
+  }
+
+  // build(i) for every column in order; if one throws, undo(i) the ones done.
+  template <typename Build, typename Undo>
+  static void allOrNothing(Build &&build, Undo &&undo) {
+    std::size_t built = 0;
+    try {
+      forEachColumn([&](auto i) {
+        build(i);
+        ++built;
+      });
+    } catch (...) {
+      forEachColumn([&](auto i) {
+        if (i < built)
+          undo(i);
+      });
+      throw;
+    }
+  }
+
+  template <std::size_t I> static Element<I> *allocate(std::size_t n) {
+    return static_cast<Element<I> *>(
+        ::operator new(n * sizeof(Element<I>), kAlign<I>));
+  }
+
+  template <std::size_t I> static void deallocate(Element<I> *p) {
+    if (p != nullptr)
+      ::operator delete(p, kAlign<I>);
+  }
+
+  static void deallocateAll(Columns &columns) {
+    forEachColumn([&](auto i) {
+      deallocate<i>(std::exchange(std::get<i>(columns), nullptr));
+    });
+  }
+
+  /* Moves the rows to new buffers of the given capacity. The n rows which
+     init(i, dst) constructs behind them are built first, while the old
+     rows are still in place, so init may read from this container. The old
+     columns are only destroyed once every row got across: copies first,
+     then the moves which may throw, then the ones which cannot. If anything
+     throws, the new buffers are cleaned up and the container stays as it
+     was, except that the kThrowingMove columns may keep moved-from rows. */
+  template <typename Init>
+  void reallocate(std::size_t capacity, std::size_t n, Init &&init) {
+    Columns fresh{};
+    bool built = false;
+    bool copied = false;
+    try {
+      forEachColumn(
+          [&](auto i) { std::get<i>(fresh) = allocate<i>(capacity); });
+
+      allOrNothing(
+          [&](auto i) { init(i, std::get<i>(fresh) + size_); },
+          [&](auto i) { std::destroy_n(std::get<i>(fresh) + size_, n); });
+      built = true;
+
+      allOrNothing(
+          [&](auto i) {
+            if constexpr (kCopyOnGrow<i>)
+              std::uninitialized_copy_n(std::get<i>(columns_), size_,
+                                        std::get<i>(fresh));
+          },
+          [&](auto i) {
+            if constexpr (kCopyOnGrow<i>)
+              std::destroy_n(std::get<i>(fresh), size_);
+          });
+      copied = true;
+
+      allOrNothing(
+          [&](auto i) {
+            if constexpr (kThrowingMove<i>)
+              std::uninitialized_move_n(std::get<i>(columns_), size_,
+                                        std::get<i>(fresh));
+          },
+          [&](auto i) {
+            if constexpr (kThrowingMove<i>)
+              std::destroy_n(std::get<i>(fresh), size_);
+          });
+    } catch (...) {
+      forEachColumn([&](auto i) {
+        if (built)
+          std::destroy_n(std::get<i>(fresh) + size_, n);
+        if constexpr (kCopyOnGrow<i>)
+          if (copied)
+            std::destroy_n(std::get<i>(fresh), size_);
+      });
+      deallocateAll(fresh);
+      throw;
+    }
+
+    forEachColumn([&](auto i) {
+      if constexpr (!kCopyOnGrow<i> && !kThrowingMove<i>)
+        std::uninitialized_move_n(std::get<i>(columns_), size_,
+                                  std::get<i>(fresh));
+    });
+
+    forEachColumn(
+        [&](auto i) { std::destroy_n(std::get<i>(columns_), size_); });
+    deallocateAll(columns_);
+
+    columns_ = fresh;
+    capacity_ = capacity;
+  }
+
+  /* Appends n rows, init(i, dst) constructs the n elements of column i at
+     dst and has to clean up after itself when it throws. */
+  template <typename Init> void append(std::size_t n, Init &&init) {
+    if (capacity_ - size_ < n)
+      reallocate(std::max(size_ + n, capacity_ * 2), n, init);
+    else
+      allOrNothing(
+          [&](auto i) { init(i, std::get<i>(columns_) + size_); },
+          [&](auto i) { std::destroy_n(std::get<i>(columns_) + size_, n); });
+    size_ += n;
+  }
+
+public:
+  SoaVector() = default;
+
+  explicit SoaVector(std::span<const Tuple> rows) {
+    reserve(rows.size());
+    for (const auto &row : rows)
+      push_back(row);
+  }
+
+  SoaVector(const SoaVector &other) {
+    append(other.size_, [&](auto i, auto *dst) {
+      std::uninitialized_copy_n(std::get<i>(other.columns_), other.size_,
+                                dst);
+    });
+  }
+
+  SoaVector(SoaVector &&other) noexcept
+      : columns_(std::exchange(other.columns_, {})),
+        size_(std::exchange(other.size_, 0)),
+        capacity_(std::exchange(other.capacity_, 0)) {}
+
+  SoaVector &operator=(const SoaVector &other) {
+    if (this != &other) {
+      SoaVector copy{other};
+      swap(copy);
+    }
+    return *this;
+  }
+
+  SoaVector &operator=(SoaVector &&other) noexcept {
+    SoaVector moved{std::move(other)};
+    swap(moved);
+    return *this;
+  }
+
+  ~SoaVector() {
+    clear();
+    deallocateAll(columns_);
+  }
+
+  void swap(SoaVector &other) noexcept {
+    std::swap(columns_, other.columns_);
+    std::swap(size_, other.size_);
+    std::swap(capacity_, other.capacity_);
+  }
+
+  std::size_t size() const { return size_; }
+  std::size_t capacity() const { return capacity_; }
+  bool empty() const { return size_ == 0; }
+
+  void reserve(std::size_t capacity) {
+    if (capacity > capacity_)
+      reallocate(capacity, 0, [](auto, auto *) {});
+  }
+
+  void clear() {
+    forEachColumn(
+        [&](auto i) { std::destroy_n(std::get<i>(columns_), size_); });
+    size_ = 0;
+  }
+
+  void push_back(const Tuple &row) {
+    append(1, [&](auto i, auto *dst) {
+      std::construct_at(dst, std::get<i>(row));
+    });
+  }
+
+  void push_back(Tuple &&row) {
+    append(1, [&](auto i, auto *dst) {
+      std::construct_at(dst, std::get<i>(std::move(row)));
+    });
+  }
+
+  // One constructor argument per column.
+  template <typename... Args>
+    requires(sizeof...(Args) == kColumns)
+  reference emplace_back(Args &&...args) {
+    auto forwarded = std::forward_as_tuple(std::forward<Args>(args)...);
+    append(1, [&](auto i, auto *dst) {
+      std::construct_at(dst, std::get<i>(std::move(forwarded)));
+    });
+    return back();
+  }
+
+  void pop_back() {
+    --size_;
+    forEachColumn(
+        [&](auto i) { std::destroy_at(std::get<i>(columns_) + size_); });
+  }
+
+  template <std::size_t I> std::span<Element<I>> column() {
+    return {std::get<I>(columns_), size_};
+  }
+  template <std::size_t I> std::span<const Element<I>> column() const {
+    return {std::get<I>(columns_), size_};
+  }
+
+  reference operator[](std::size_t i) { return {*this, i}; }
+  const_reference operator[](std::size_t i) const { return {*this, i}; }
+  reference back() { return (*this)[size_ - 1]; }
+  const_reference back() const { return (*this)[size_ - 1]; }
+
+  iterator begin() { return {*this, 0}; }
+  iterator end() { return {*this, static_cast<std::ptrdiff_t>(size_)}; }
+  const_iterator begin() const { return {*this, 0}; }
+  const_iterator end() const {
+    return {*this, static_cast<std::ptrdiff_t>(size_)};
+  }
+
+  std::vector<Tuple> toVector() const {
+    std::vector<Tuple> rows{};
+    rows.reserve(size_);
+    for (std::size_t i = 0; i < size_; ++i)
+      rows.push_back(static_cast<Tuple>((*this)[i]));
+    return rows;
+  }
+
+  friend bool operator==(const SoaVector &lhs, const SoaVector &rhs)
+    requires std::equality_comparable<Tuple>
+  {
+    return [&]<std::size_t... I>(std::index_sequence<I...>) {
+      return lhs.size_ == rhs.size_ &&
+             (std::ranges::equal(lhs.column<I>(), rhs.column<I>()) && ...);
+    }(std::make_index_sequence<kColumns>{});
+  }
+};
+
+} // namespace l6
+
+template <l6::TupleLike Tuple, bool Const>
+struct std::tuple_size<l6::SoaReference<Tuple, Const>>
+    : std::tuple_size<Tuple> {};
+
+template <std::size_t I, l6::TupleLike Tuple, bool Const>
+struct std::tuple_element<I, l6::SoaReference<Tuple, Const>> {
+  using type = std::conditional_t<Const, const std::tuple_element_t<I, Tuple>,
+                                  std::tuple_element_t<I, Tuple>> &;
+};
+
+#endif // __L6_TUPLE_SORT_SOA_VECTOR_HH__
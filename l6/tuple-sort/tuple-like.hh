@@ -0,0 +1,40 @@
+#ifndef __L6_TUPLE_SORT_TUPLE_LIKE_HH__
+#define __L6_TUPLE_SORT_TUPLE_LIKE_HH__
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+namespace l6 {
+
+template <typename T>
+concept TupleLike = requires {
+  typename std::tuple_size<T>::type;
+  typename std::tuple_element<0, T>::type;
+  std::get<0>(std::declval<T>());
+};
+
+/* Same kind of tuple-like with other element types: Tmpl<Us...> for
+   Tmpl<Ts...>, the same std::array (all its elements have one type) and
+   std::tuple<Us...> for anything else. */
+template <typename Tuple, typename... Us> struct Rebind {
+  using type = std::tuple<Us...>;
+};
+
+template <template <typename...> class Tmpl, typename... Ts, typename... Us>
+struct Rebind<Tmpl<Ts...>, Us...> {
+  using type = Tmpl<Us...>;
+};
+
+template <typename T, std::size_t N, typename... Us>
+struct Rebind<std::array<T, N>, Us...> {
+  using type = std::array<T, N>;
+};
+
+template <typename Tuple, typename... Us>
+using RebindT = typename Rebind<Tuple, Us...>::type;
+
+} // namespace l6
+
+#endif // __L6_TUPLE_SORT_TUPLE_LIKE_HH__
@@ -0,0 +1,101 @@
+#ifndef __L6_TUPLE_SORT_TUPLE_SORT_HH__
+#define __L6_TUPLE_SORT_TUPLE_SORT_HH__
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <boost/hana.hpp>
+#include <boost/hana/fwd/sort.hpp>
+#include <boost/hana/fwd/transform.hpp>
+#include <boost/hana/fwd/tuple.hpp>
+#include <boost/hana/fwd/type.hpp>
+#include <boost/hana/fwd/unpack.hpp>
+
+#include "permutation.hh"
+#include "tuple-like.hh"
+
+namespace l6 {
+
+namespace hana = boost::hana;
+
+template <TupleLike Tuple, std::size_t... I>
+constexpr auto toHana(const Tuple &tuple, std::index_sequence<I...>) {
+  return hana::make_tuple(std::make_pair(
+      hana::type_c<std::tuple_element<I, Tuple>>, std::get<I>(tuple))...);
+}
+
+/* Reference implementation: hana::sort over (type, value) pairs. Kept to
+   compare against sort() in the compile time benchmark. */
+template <TupleLike Tuple> constexpr auto hanaSort(Tuple t) {
+  auto ht = toHana(t, std::make_index_sequence<std::tuple_size_v<Tuple>>{});
+  auto sorted = hana::sort(
+      ht, [](auto l, auto r) { return hana::sizeof_(l) < hana::sizeof_(r); });
+
+  return hana::unpack(sorted, [](auto... e) {
+    return RebindT<Tuple,
+                   typename decltype(e.first)::type::type...>{e.second...};
+  });
+}
+
+namespace detail {
+
+struct SortKey final {
+  std::size_t size;
+  std::size_t align;
+
+  constexpr bool operator<(const SortKey &other) const {
+    if (size != other.size)
+      return size < other.size;
+    return align < other.align;
+  }
+};
+
+template <typename... Ts> consteval auto sortKeys() {
+  return std::array<SortKey, sizeof...(Ts)>{
+      SortKey{sizeof(Ts), alignof(Ts)}...};
+}
+
+// Keys from the element types, straight from the pack when there is one.
+template <typename Tuple> struct SortKeys {
+  static consteval auto get() {
+    return []<std::size_t... I>(std::index_sequence<I...>) {
+      return sortKeys<std::tuple_element_t<I, Tuple>...>();
+    }(std::make_index_sequence<std::tuple_size_v<Tuple>>{});
+  }
+};
+
+template <template <typename...> class Tmpl, typename... Ts>
+struct SortKeys<Tmpl<Ts...>> {
+  static consteval auto get() { return sortKeys<Ts...>(); }
+};
+
+} // namespace detail
+
+/* kSortOrder<Tuple>[k] is the index of the element which goes k-th: by
+   size, then alignment, equal elements keep their order. */
+template <TupleLike Tuple>
+inline constexpr auto kSortOrder = stableOrder(detail::SortKeys<Tuple>::get());
+
+/* Reorders the elements of a tuple-like by size. The permutation is a
+   constexpr array, applying it is a single pack expansion, so there is no
+   type-level sorting to instantiate. Every element goes through
+   std::get<I>(std::forward<Tuple>(t)) once: an rvalue tuple is moved from,
+   an lvalue one is copied exactly once and references stay references. */
+template <typename Tuple>
+  requires TupleLike<std::remove_cvref_t<Tuple>>
+constexpr auto sort(Tuple &&t) {
+  using Source = std::remove_cvref_t<Tuple>;
+
+  return [&]<std::size_t... K>(std::index_sequence<K...>) {
+    using Result = RebindT<Source, std::tuple_element_t<kSortOrder<Source>[K],
+                                                        Source>...>;
+    return Result{std::get<kSortOrder<Source>[K]>(std::forward<Tuple>(t))...};
+  }(std::make_index_sequence<std::tuple_size_v<Source>>{});
+}
+
+} // namespace l6
+
+#endif // __L6_TUPLE_SORT_TUPLE_SORT_HH__